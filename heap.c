@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <limits.h>
 
 #include "heap.h"
 
@@ -16,6 +17,17 @@ struct heap_node {
     uint32_t mark;
 };
 
+//nodes in the first slab of a heap, each next slab holding twice as many up to HEAP_SLAB_MAX_NODES
+#define HEAP_SLAB_MIN_NODES 64
+#define HEAP_SLAB_MAX_NODES 65536
+
+typedef struct heap_slab {
+    struct heap_slab *next;
+    uint32_t capacity;
+    uint32_t used;
+    heap_node_t nodes[];
+} heap_slab_t;
+
 #define swap(a, b) ({    \
   typeof (a) _tmp = (a); \
   (a) = (b);             \
@@ -43,11 +55,47 @@ struct heap_node {
   (n)->prev->next = (n)->next;           \
 })
 
-//authored by Maxim Popov because swap did not work in C++ project
-void swap_2(heap_node_t *a, heap_node_t *b) {
-    heap_node_t *_tmp = a;
-    a = b;
-    b = _tmp;
+//authored by Maxim Popov because swap did not work in C++ project, swaps the pointers a and b point to
+static void swap_2(heap_node_t **a, heap_node_t **b) {
+    heap_node_t *_tmp = *a;
+    *a = *b;
+    *b = _tmp;
+}
+
+static heap_node_t *heap_node_alloc(heap_t *h)
+{
+    heap_node_t *n;
+    heap_slab_t *s;
+    uint32_t capacity;
+
+    if ((n = h->free_nodes)) {
+        h->free_nodes = n->next;
+    } else {
+        s = h->slabs;
+        if (!s || s->used == s->capacity) {
+            capacity = s ? s->capacity * 2 : HEAP_SLAB_MIN_NODES;
+            if (capacity > HEAP_SLAB_MAX_NODES) {
+                capacity = HEAP_SLAB_MAX_NODES;
+            }
+            /* Not inside the assert, which release builds compile out. */
+            s = (heap_slab_t *) malloc(sizeof (*s) + capacity * sizeof (heap_node_t));
+            assert(s);
+            s->next = h->slabs;
+            s->capacity = capacity;
+            s->used = 0;
+            h->slabs = s;
+        }
+        n = &s->nodes[s->used++];
+    }
+    memset(n, 0, sizeof (*n));
+
+    return n;
+}
+
+static void heap_node_free(heap_t *h, heap_node_t *n)
+{
+    n->next = h->free_nodes;
+    h->free_nodes = n;
 }
 
 void print_heap_node(heap_node_t *n, unsigned indent,
@@ -107,8 +155,11 @@ void heap_init(heap_t *h,
     h->size = 0;
     h->compare = compare;
     h->datum_delete = datum_delete;
+    h->slabs = NULL;
+    h->free_nodes = NULL;
 }
 
+//nodes themselves go with their slabs, so this only deletes the data
 void heap_node_delete(heap_t *h, heap_node_t *hn)
 {
     heap_node_t *next;
@@ -119,19 +170,23 @@ void heap_node_delete(heap_t *h, heap_node_t *hn)
             heap_node_delete(h, hn->child);
         }
         next = hn->next;
-        if (h->datum_delete) {
-            h->datum_delete(hn->datum);
-        }
-        free(hn);
+        h->datum_delete(hn->datum);
         hn = next;
     }
 }
 
 void heap_delete(heap_t *h)
 {
-    if (h->min) {
+    heap_slab_t *s;
+
+    if (h->min && h->datum_delete) {
         heap_node_delete(h, h->min);
     }
+    while ((s = h->slabs)) {
+        h->slabs = s->next;
+        free(s);
+    }
+    h->free_nodes = NULL;
     h->min = NULL;
     h->size = 0;
     h->compare = NULL;
@@ -142,7 +197,7 @@ heap_node_t *heap_insert(heap_t *h, void *v)
 {
     heap_node_t *n;
 
-    assert((n = (heap_node_t *) calloc(1, sizeof (*n))));
+    n = heap_node_alloc(h);
     n->datum = v;
 
     if (h->min) {
@@ -195,7 +250,7 @@ static void heap_consolidate(heap_t *h)
         while (a[x->degree]) {
             y = a[x->degree];
             if (h->compare(x->datum, y->datum) > 0) {
-                swap_2(x, y);
+                swap_2(&x, &y);
             }
             a[x->degree] = NULL;
             heap_link(h, y, x);
@@ -228,7 +283,7 @@ void *heap_remove_min(heap_t *h)
     if (h->min) {
         v = h->min->datum;
         if (h->size == 1) {
-            free(h->min);
+            heap_node_free(h, h->min);
             h->min = NULL;
         } else {
             if ((n = h->min->child)) {
@@ -242,7 +297,7 @@ void *heap_remove_min(heap_t *h)
             n = h->min;
             remove_heap_node_from_list(n);
             h->min = n->next;
-            free(n);
+            heap_node_free(h, n);
 
             heap_consolidate(h);
         }
@@ -255,29 +310,46 @@ void *heap_remove_min(heap_t *h)
 
 int heap_combine(heap_t *h, heap_t *h1, heap_t *h2)
 {
+    heap_t combined;
+    heap_slab_t **s;
+    heap_node_t **n;
+
     if (h1->compare != h2->compare ||
         h1->datum_delete != h2->datum_delete) {
         return 1;
     }
 
-    h->compare = h1->compare;
-    h->datum_delete = h1->datum_delete;
+    combined.compare = h1->compare;
+    combined.datum_delete = h1->datum_delete;
 
     if (!h1->min) {
-        h->min = h2->min;
-        h->size = h2->size;
+        combined.min = h2->min;
+        combined.size = h2->size;
     } else if (!h2->min) {
-        h->min = h1->min;
-        h->size = h1->size;
+        combined.min = h1->min;
+        combined.size = h1->size;
     } else {
-        h->min = ((h->compare(h1->min->datum, h2->min->datum) < 0) ?
-                  h1->min                                          :
-                  h2->min);
+        combined.min = ((combined.compare(h1->min->datum, h2->min->datum) < 0) ?
+                        h1->min                                                 :
+                        h2->min);
+        combined.size = h1->size + h2->size;
         splice_heap_node_lists(h1->min, h2->min);
     }
 
+    /* The nodes of both heaps now make up one, so it owns the slabs *
+     * and free nodes of both.                                        */
+    for (s = &h1->slabs; *s; s = &(*s)->next)
+        ;
+    *s = h2->slabs;
+    combined.slabs = h1->slabs;
+    for (n = &h1->free_nodes; *n; n = &(*n)->next)
+        ;
+    *n = h2->free_nodes;
+    combined.free_nodes = h1->free_nodes;
+
     memset(h1, 0, sizeof (*h1));
     memset(h2, 0, sizeof (*h2));
+    *h = combined;
 
     return 0;
 }
@@ -305,7 +377,7 @@ static void heap_cascading_cut(heap_t *h, heap_node_t *n)
             n->mark = 1;
         } else {
             heap_cut(h, n, p);
-            heap_cascading_cut(h, n);
+            heap_cascading_cut(h, p);
         }
     }
 }
@@ -362,50 +434,100 @@ char *print_int(const void *v)
   return out;
 }
 
+/* Runs random inserts, decrease keys and remove mins on a heap of up to *
+ * n keys, checking every removed key against the smallest key a plain  *
+ * array says is left.                                                   */
 int main(int argc, char *argv[])
 {
-  heap_t h;
-  int **keys;
+  heap_t h, h2;
+  int *keys;
+  char *in;
   heap_node_t **a;
-  /*  int *p;*/
-  int i, j;
-  int n;
+  int i, j, k, min, *v;
+  int n, size, operations;
 
   if (argc == 2) {
     n = atoi(argv[1]);
   } else {
-    n = 20;
+    n = 5000;
   }
 
-  assert((keys = calloc(n, sizeof (*keys))));
-  assert((a = calloc(n, sizeof (*a))));
+  keys = calloc(n, sizeof (*keys));
+  in = calloc(n, sizeof (*in));
+  a = calloc(n, sizeof (*a));
+  if (!keys || !in || !a) {
+    printf("could not allocate %d keys\n", n);
+    return 1;
+  }
 
-  heap_init(&h, compare, free);
+  heap_init(&h, compare, NULL);
+  srand(1);
+  size = 0;
+  for (operations = 0; operations < 200 * n; operations++) {
+    j = rand() % n;
+    k = rand() % 4;
+    if (!in[j] && k < 2) {
+      keys[j] = rand() % (4 * n);
+      in[j] = 1;
+      a[j] = heap_insert(&h, &keys[j]);
+      size++;
+    } else if (in[j] && k == 2) {
+      keys[j] -= rand() % 100;
+      heap_decrease_key_no_replace(&h, a[j]);
+    } else if (size) {
+      for (min = INT_MAX, i = 0; i < n; i++) {
+        if (in[i] && keys[i] < min) {
+          min = keys[i];
+        }
+      }
+      v = heap_remove_min(&h);
+      if (!v) {
+        printf("heap empty with %d keys left, after %d operations\n", size, operations);
+        return 1;
+      }
+      if (*v != min) {
+        printf("removed %d, smallest key is %d, after %d operations\n", *v, min, operations);
+        return 1;
+      }
+      in[v - keys] = 0;
+      size--;
+    }
+    assert(h.size == (uint32_t) size);
+  }
 
+  /* A combined heap gives up all keys of both in order. */
+  heap_init(&h2, compare, NULL);
   for (i = 0; i < n; i++) {
-    assert((keys[i] = malloc(sizeof (*keys[i]))));
-    *keys[i] = i;
-    a[i] = heap_insert(&h, keys[i]);
+    if (!in[i]) {
+      keys[i] = rand() % (4 * n);
+      heap_insert(&h2, &keys[i]);
+    }
   }
-
-  print_heap(&h, print_int);
-  printf("------------------------------------\n");
-
-  heap_remove_min(&h);
-  assert((keys[0] = malloc(sizeof (*keys[0]))));
-  *keys[0] = 0;
-  a[0] = heap_insert(&h, keys[0]);
-  for (i = 0; i < 100 * n; i++) {
-    j = rand() % n;
-    /*    assert((p = malloc (sizeof (*p))));*/
-    (*(int *) a[j]->datum)--;
-    /*    (*p)--;*/
-    heap_decrease_key_no_replace(&h, a[j]);
-    print_heap(&h, print_int);
-    printf("------------------------------------\n");
+  heap_combine(&h, &h, &h2);
+  assert(h.size == (uint32_t) n);
+  for (min = INT_MIN, i = 0; i < n; i++) {
+    v = heap_remove_min(&h);
+    if (!v) {
+      printf("combined heap empty after %d of %d keys\n", i, n);
+      return 1;
+    }
+    if (*v < min) {
+      printf("removed %d after %d from the combined heap\n", *v, min);
+      return 1;
+    }
+    min = *v;
   }
+  if (heap_remove_min(&h)) {
+    printf("combined heap not empty after %d keys\n", n);
+    return 1;
+  }
+  heap_delete(&h);
+
+  printf("%d operations on up to %d keys: ok\n", operations, n);
 
   free(keys);
+  free(in);
+  free(a);
 
   return 0;
 }
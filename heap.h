@@ -10,12 +10,16 @@ extern "C" {
 //Authored by Professor Jeremy Sheaffer
 struct heap_node;
 typedef struct heap_node heap_node_t;
+struct heap_slab;
 
 typedef struct heap {
     heap_node_t *min;
     uint32_t size;
     int32_t (*compare)(const void *key, const void *with);
     void (*datum_delete)(void *);
+    //nodes are carved out of slabs the heap owns, and removed ones are kept for the next insert
+    struct heap_slab *slabs;
+    heap_node_t *free_nodes;
 } heap_t;
 
 void heap_init(heap_t *h,
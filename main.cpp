@@ -2,14 +2,35 @@
 #include <ctime>
 #include <climits>
 #include <cmath>
+#include <cstring>
 #include <getopt.h>
 #include <ncurses.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <string>
+#include <string_view>
+#include <charconv>
+#include <chrono>
+#include <stdexcept>
+#include <type_traits>
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <list>
+#include <queue>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <sstream>
 #include <thread>
 #include "heap.h"
+#include "priority_queue.h"
 
 //Author Maxim Popov
 
@@ -21,9 +42,21 @@
 #define WORLD_CENTER_X 199
 #define WORLD_CENTER_Y 199
 #define TERRAIN_BORDER_WEIGHT 1
+#define TERRAIN_TYPES 10
+#define TILE_BORDER_WORDS ((TILE_WIDTH_X + 31) / 32)
 #define MINIMUM_TURN 5
+//turns ahead the turn scheduler keeps in buckets, more than any single step (MINIMUM_TURN or a terrain weight) takes
+#define TURN_WHEEL_SLOTS 64
+//most turns trainers of a tile are simulated for when the PC comes back to it, before which they only wait
+#define CATCH_UP_TURNS 1000
+//buckets of the distance queue, more than the largest rival_weight and hiker_weight
+#define DISTANCE_BUCKETS 16
+//distance fields the tile the PC is on keeps, enough for both trainer types over a few cells walked back and forth
+#define DISTANCE_CACHE_ENTRIES 8
 //77 = minimum number of paths in Tile - 1 for PC so all trainers can be placed
 #define MAX_NUM_TRAINERS 77
+//default memory visited tiles may use before the least recently used are written to disk, in KB
+#define WORLD_MEMORY_BUDGET (64 * 1024)
 #define INVERSE_POKEMON_ENCOUNTER_CHANCE 10
 #define BLACK COLOR_PAIR(1)
 #define RED COLOR_PAIR(2)
@@ -34,6 +67,36 @@
 #define CYAN COLOR_PAIR(7)
 #define WHITE COLOR_PAIR(8)
 #define MAXIMUM_LEVEL 100
+//value of a numeric pokedex field left empty in the csv
+#define POKEDEX_NULL INT_MIN
+//string pool offset of a text pokedex field left empty in the csv
+#define POKEDEX_NULL_STRING UINT32_MAX
+//used when a pokemon has no level up moves to pick from
+#define STRUGGLE_MOVE_ID 165
+#define POKEDEX_SNAPSHOT_PATH "pokedex/pokedex.bin"
+#define POKEDEX_SNAPSHOT_MAGIC "PKDX"
+#define POKEDEX_SNAPSHOT_VERSION 4
+#define REGION_FILE_MAGIC "PKRG"
+#define REGION_FILE_VERSION 1
+//tiles pregenerate generates in parallel before writing them out
+#define REGION_BATCH_SIZE 1024
+#define POKEDEX_TABLES 9
+//types in the type efficacy chart, by type id 1 to TYPE_COUNT
+#define TYPE_COUNT 18
+//csv files larger than this are split into chunks of about this size that are parsed on separate threads
+#define POKEDEX_CHUNK_SIZE (128 * 1024)
+//table dumps are written to stdout in blocks of about this size
+#define DUMP_BUFFER_SIZE (1024 * 1024)
+//events of a battle turn: for each of two attacks the move, a hit or miss, a faint, experience and a level up
+#define BATTLE_LOG_CAPACITY 16
+//turns after which a simulated battle counts as a draw, as when neither side has a move that does damage
+#define SIMULATED_TURN_LIMIT 1000
+//simulated battles a thread takes at a time
+#define SIMULATED_BATTLE_BATCH 4096
+//buckets of the health a party has left after simulated battles: none, then tenths of its maximum
+#define HEALTH_BUCKETS 11
+//most pokemon a character holds
+#define PARTY_SIZE 6
 //index = level, value = experience required for that level
 int levelUpExperienceCost[] = {0, 0, 6, 21, 51, 100, 172, 274, 409, 583,
    800,1064, 1382, 1757, 2195, 2700, 3276, 3930, 4665, 5487,
@@ -65,6 +128,25 @@ enum combat_option {
     RUN
 };
 
+enum battle_event_type {
+    BATTLE_MOVE_USED,
+    BATTLE_DAMAGE,
+    BATTLE_MISSED,
+    BATTLE_FAINTED,
+    BATTLE_EXPERIENCE,
+    BATTLE_LEVEL_UP,
+    BATTLE_RAN_AWAY,
+    BATTLE_RUN_FAILED
+};
+
+//how grow_seeds picks the terrain of a cell reached by more than one seed in the same round
+enum growth_mode {
+    //the last one found scanning its neighbors, as the original fixed point loop did
+    GROWTH_NEIGHBOR_SCAN,
+    //that of the neighbor which reached it first
+    GROWTH_FIRST_REACHED
+};
+
 class Terrain {
 public:
     int id;
@@ -82,26 +164,81 @@ public:
         rival_weight(rival_weight), hiker_weight(hiker_weight), color(color) {}
 };
 
-static Terrain *none = new Terrain(0, '_', 0, 0, 0,
-                                   0, BLACK);
-static Terrain *edge = new Terrain(1, '%', INT_MAX, INT_MAX, INT_MAX,
-                                   INT_MAX, WHITE);
-static Terrain *clearing = new Terrain(2, '.', 5, 10, 10,
-                                       5, YELLOW);
-static Terrain *grass = new Terrain(3, ',', 10, 15, 15,
-                                    5, GREEN);
-static Terrain *forest = new Terrain(4, '^', 100, INT_MAX, INT_MAX,
-                                     10, GREEN);
-static Terrain *mountain = new Terrain(5, '%', 150, INT_MAX, INT_MAX,
-                                       10, WHITE);
-static Terrain *lake = new Terrain(6, '~', 200, INT_MAX, INT_MAX,
-                                   INT_MAX, BLUE);
-static Terrain *path = new Terrain(7, '#', 0, 5, 5,
-                                   5, YELLOW);
-static Terrain *center = new Terrain(8, 'C', INT_MAX, 5, INT_MAX,
-                                     INT_MAX, MAGENTA);
-static Terrain *mart = new Terrain(9, 'M', INT_MAX, 5, INT_MAX,
-                                   INT_MAX, MAGENTA);
+//properties of every terrain, shared by all tiles which only store the id of each cell's terrain
+static Terrain terrains[TERRAIN_TYPES] = {
+    Terrain(0, '_', 0, 0, 0, 0, BLACK),
+    Terrain(1, '%', INT_MAX, INT_MAX, INT_MAX, INT_MAX, WHITE),
+    Terrain(2, '.', 5, 10, 10, 5, YELLOW),
+    Terrain(3, ',', 10, 15, 15, 5, GREEN),
+    Terrain(4, '^', 100, INT_MAX, INT_MAX, 10, GREEN),
+    Terrain(5, '%', 150, INT_MAX, INT_MAX, 10, WHITE),
+    Terrain(6, '~', 200, INT_MAX, INT_MAX, INT_MAX, BLUE),
+    Terrain(7, '#', 0, 5, 5, 5, YELLOW),
+    Terrain(8, 'C', INT_MAX, 5, INT_MAX, INT_MAX, MAGENTA),
+    Terrain(9, 'M', INT_MAX, 5, INT_MAX, INT_MAX, MAGENTA)
+};
+
+static Terrain *none = &terrains[0];
+static Terrain *edge = &terrains[1];
+static Terrain *clearing = &terrains[2];
+static Terrain *grass = &terrains[3];
+static Terrain *forest = &terrains[4];
+static Terrain *mountain = &terrains[5];
+static Terrain *lake = &terrains[6];
+static Terrain *path = &terrains[7];
+static Terrain *center = &terrains[8];
+static Terrain *mart = &terrains[9];
+
+/*
+ * Counter based random numbers (SplitMix64): the n-th number of a stream only depends on the stream's key and n, so
+ * a stream can be recreated from its key and streams share no state between threads.
+ */
+class CounterRandom {
+public:
+    uint64_t key;
+    uint64_t counter;
+
+    CounterRandom(uint64_t key) : key(key), counter(0) {}
+
+    static uint64_t mix(uint64_t value) {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    uint64_t next() {
+        counter++;
+        return mix(key + counter * 0x9E3779B97F4A7C15ULL);
+    }
+
+    //uniform in [0, bound)
+    int below(int bound) {
+        return (int) (((next() >> 32) * (uint64_t) bound) >> 32);
+    }
+};
+
+uint64_t world_seed;
+enum growth_mode growth_mode = GROWTH_NEIGHBOR_SCAN;
+//stream generation draws from on this thread, rand() when there is none
+thread_local CounterRandom *generation_random = NULL;
+
+/*
+ * @return the key of the random stream a tile is generated from, a function of the world seed and its coordinates only
+ */
+uint64_t tile_random_key(int x, int y, int stream) {
+
+    return CounterRandom::mix(CounterRandom::mix(world_seed) ^ ((uint64_t) (uint32_t) x << 32 | (uint32_t) y)) + stream;
+
+}
+
+int random_below(int bound) {
+
+    if (generation_random != NULL) {
+        return generation_random->below(bound);
+    }
+    return rand() % bound;
+
+}
 
 //commented due to failing make
 //class DatabaseInfo {
@@ -109,67 +246,204 @@ static Terrain *mart = new Terrain(9, 'M', INT_MAX, 5, INT_MAX,
 //    virtual std::string toString();
 //};
 
+/*
+ * Characters of the string columns in the pokedex tables. Columns store offsets into the pool instead of std::strings
+ * so that they are plain data and can be written to and mapped from a pokedex snapshot as they are. Equal strings
+ * added after loading share one offset.
+ */
+class StringPool {
+public:
+    //characters mapped from a pokedex snapshot, offsets below mappedSize address these
+    const char *mapped;
+    uint32_t mappedSize;
+    //characters added after loading, offsets from mappedSize onwards address these
+    std::vector<char> added;
+
+    StringPool() : mapped(NULL), mappedSize(0), internedCount(0) {}
+
+    uint32_t add(std::string_view string) {
+        std::lock_guard<std::mutex> guard(addLock);
+        if ((internedCount + 1) * 2 > interned.size()) {
+            growInterned();
+        }
+        size_t slot = hash(string) & (interned.size() - 1);
+        while (interned[slot] != POKEDEX_NULL_STRING) {
+            if (string == get(interned[slot])) {
+                return interned[slot];
+            }
+            slot = (slot + 1) & (interned.size() - 1);
+        }
+        uint32_t offset = mappedSize + (uint32_t) added.size();
+        added.insert(added.end(), string.begin(), string.end());
+        added.push_back('\0');
+        interned[slot] = offset;
+        internedCount++;
+        return offset;
+    }
+
+    const char *get(uint32_t offset) const {
+        if (offset == POKEDEX_NULL_STRING) {
+            return "";
+        }
+        if (offset < mappedSize) {
+            return mapped + offset;
+        }
+        return &added[offset - mappedSize];
+    }
+
+    uint32_t size() const {
+        return mappedSize + (uint32_t) added.size();
+    }
+
+private:
+    //open addressed set of the offsets of added strings, by hash of the string, so adding needs no std::string
+    std::vector<uint32_t> interned;
+    size_t internedCount;
+    //tables are read from csv on several threads at once
+    std::mutex addLock;
+
+    static size_t hash(std::string_view string) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < string.size(); i++) {
+            hash = (hash ^ (unsigned char) string[i]) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    void growInterned() {
+        std::vector<uint32_t> old(interned.size() < 64 ? 64 : interned.size() * 2, POKEDEX_NULL_STRING);
+        old.swap(interned);
+        for (size_t i = 0; i < old.size(); i++) {
+            if (old[i] != POKEDEX_NULL_STRING) {
+                size_t slot = hash(get(old[i])) & (interned.size() - 1);
+                while (interned[slot] != POKEDEX_NULL_STRING) {
+                    slot = (slot + 1) & (interned.size() - 1);
+                }
+                interned[slot] = old[i];
+            }
+        }
+    }
+};
+
+StringPool pokedexStrings;
+
+/*
+ * Values of one field of a pokedex table, stored contiguously. Values read from csv are owned by the column, values
+ * loaded from a pokedex snapshot point straight into the mapped file and are copied out only if appended to.
+ */
+template <typename T>
+class Column {
+public:
+    Column() : values(NULL), count(0) {}
+    //values may point into the column's own storage, so columns are not copied
+    Column(const Column &) = delete;
+    Column &operator=(const Column &) = delete;
+
+    void push_back(const T &value) {
+        if (values != owned.data()) {
+            owned.assign(values, values + count);
+        }
+        owned.push_back(value);
+        values = owned.data();
+        count = (uint32_t) owned.size();
+    }
+
+    void reserve(uint32_t extra) {
+        if (values != owned.data()) {
+            owned.assign(values, values + count);
+        }
+        owned.reserve(count + extra);
+        values = owned.data();
+    }
+
+    void append(const Column &other) {
+        if (values != owned.data()) {
+            owned.assign(values, values + count);
+        }
+        owned.insert(owned.end(), other.values, other.values + other.count);
+        values = owned.data();
+        count = (uint32_t) owned.size();
+    }
+
+    void view(const T *mappedValues, uint32_t mappedCount) {
+        owned.clear();
+        values = mappedValues;
+        count = mappedCount;
+    }
+
+    void clear() {
+        view(NULL, 0);
+    }
+
+    const T &operator[](uint32_t i) const {
+        return values[i];
+    }
+
+    const T *data() const {
+        return values;
+    }
+
+    uint32_t size() const {
+        return count;
+    }
+
+private:
+    std::vector<T> owned;
+    const T *values;
+    uint32_t count;
+};
+
+//appends one field of a row's csv form, null fields are left empty
+static void appendField(std::string &string, int value, bool last = false) {
+    if (value != POKEDEX_NULL) {
+        string += std::to_string(value);
+    }
+    if (!last) {
+        string += ",";
+    }
+}
+
+static void appendStringField(std::string &string, uint32_t offset, bool last = false) {
+    string += pokedexStrings.get(offset);
+    if (!last) {
+        string += ",";
+    }
+}
+
+/*
+ * One row of the pokemon table, as held by a PokemonIndexEntry.
+ */
 class PokemonInfo {
 public:
     int id;
-    std::string name;
+    uint32_t nameOffset;
     int species_id;
     int height;
     int weight;
     int base_experience;
     int order;
     int is_default;
-    std::string pokemonString;
+
+    PokemonInfo() {}
 
     PokemonInfo(std::string id, std::string name, std::string species_id, std::string height, std::string weight,
                 std::string base_experience, std::string order, std::string is_default) :
-        id(stoi(id)), name(name), species_id(stoi(species_id)), height(stoi(height)), weight(stoi(weight)),
-        base_experience(stoi(base_experience)), order(stoi(order)), is_default(stoi(is_default)) {
-        pokemonString = "";
-        if (this->id != -1) {
-            pokemonString += id;
-        }
-        pokemonString += ",";
-        if (this->name != "-1") {
-            pokemonString += name;
-        }
-        pokemonString += ",";
-        if (this->species_id != -1) {
-            pokemonString += species_id;
-        }
-        pokemonString += ",";
-        if (this->height != -1) {
-            pokemonString += height;
-        }
-        pokemonString += ",";
-        if (this->weight != -1) {
-            pokemonString += weight;
-        }
-        pokemonString += ",";
-        if (this->base_experience != -1) {
-            pokemonString += base_experience;
-        }
-        pokemonString += ",";
-        if (this->order != -1) {
-            pokemonString += order;
-        }
-        pokemonString += ",";
-        if (this->is_default != -1) {
-            pokemonString += is_default;
-        }
-        pokemonString = id + "," + name + "," + species_id + "," + height + "," + weight + "," + base_experience + "," +
-                order + "," + is_default;
-    }
+        id(stoi(id)), nameOffset(pokedexStrings.add(name)), species_id(stoi(species_id)), height(stoi(height)),
+        weight(stoi(weight)), base_experience(stoi(base_experience)), order(stoi(order)),
+        is_default(stoi(is_default)) {}
 
-    std::string toString() {
-        return pokemonString;
+    const char *getName() const {
+        return pokedexStrings.get(nameOffset);
     }
 };
 
+/*
+ * One row of the moves table, as held by a Pokemon.
+ */
 class Move {
 public:
     int id;
-    std::string name;
+    uint32_t nameOffset;
     int generation_id;
     int type_id;
     int power;
@@ -183,14 +457,15 @@ public:
     int contest_type_id;
     int contest_effect_id;
     int super_contest_effect_id;
-    std::string moveString;
+
+    Move() {}
 
     Move(std::string id, std::string name, std::string generation_id, std::string type_id, std::string power,
     std::string pp, std::string accuracy, std::string priority, std::string target_id, std::string damage_class_id,
          std::string effect_id, std::string effect_chance, std::string contest_type_id, std::string contest_effect_id,
          std::string super_contest_effect_id) {
         this->id = stoi(id);
-        this->name = name;
+        this->nameOffset = pokedexStrings.add(name);
         this->generation_id = stoi(generation_id);
         this->type_id = stoi(type_id);
         this->power = stoi(power);
@@ -204,455 +479,660 @@ public:
         this->contest_type_id = stoi(contest_type_id);
         this->contest_effect_id = stoi(contest_effect_id);
         this->super_contest_effect_id = stoi(super_contest_effect_id);
-        moveString = "";
-        if (this->id != -1) {
-            moveString += id;
-        }
-        moveString += ",";
-        if (this->name != "-1") {
-            moveString += name;
-        }
-        moveString += ",";
-        if (this->generation_id != -1) {
-            moveString += generation_id;
-        }
-        moveString += ",";
-        if (this->type_id != -1) {
-            moveString += type_id;
-        }
-        moveString += ",";
-        if (this->power != -1) {
-            moveString += power;
-        }
-        moveString += ",";
-        if (this->pp != -1) {
-            moveString += pp;
-        }
-        moveString += ",";
-        if (this->accuracy != -1) {
-            moveString += accuracy;
-        }
-        moveString += ",";
-        if (this->priority != -1) {
-            moveString += priority;
-        }
-        moveString += ",";
-        if (this->target_id != -1) {
-            moveString += target_id;
-        }
-        moveString += ",";
-        if (this->damage_class_id != -1) {
-            moveString += damage_class_id;
-        }
-        moveString += ",";
-        if (this->effect_id != -1) {
-            moveString += effect_id;
-        }
-        moveString += ",";
-        if (this->effect_chance != -1) {
-            moveString += effect_chance;
-        }
-        moveString += ",";
-        if (this->contest_type_id != -1) {
-            moveString += contest_type_id;
-        }
-        moveString += ",";
-        if (this->contest_effect_id != -1) {
-            moveString += contest_effect_id;
-        }
-        moveString += ",";
-        if (this->super_contest_effect_id != -1) {
-            moveString += super_contest_effect_id;
-        }
     }
 
-    std::string toString() {
-        return moveString;
+    const char *getName() const {
+        return pokedexStrings.get(nameOffset);
     }
 };
 
-class PokemonMove {
+/*
+ * The pokedex tables below keep one Column per csv field: Column<int> for numbers and Column<uint32_t> of string pool
+ * offsets for text. Each lists its columns in csv order in forEachColumn, which is the schema csv loading and the
+ * pokedex snapshot work from.
+ */
+class PokemonTable {
 public:
-    int pokemon_id;
-    int version_group_id;
-    int move_id;
-    int pokemon_move_method_id;
-    int level;
-    int order;
-    std::string pokemonMoveString;
+    Column<int> id;
+    Column<uint32_t> name;
+    Column<int> species_id;
+    Column<int> height;
+    Column<int> weight;
+    Column<int> base_experience;
+    Column<int> order;
+    Column<int> is_default;
+
+    template <typename F>
+    void forEachColumn(F visit) {
+        visit(id); visit(name); visit(species_id); visit(height); visit(weight); visit(base_experience); visit(order);
+        visit(is_default);
+    }
+
+    PokemonInfo row(uint32_t i) const {
+        PokemonInfo pokemonInfo;
+        pokemonInfo.id = id[i];
+        pokemonInfo.nameOffset = name[i];
+        pokemonInfo.species_id = species_id[i];
+        pokemonInfo.height = height[i];
+        pokemonInfo.weight = weight[i];
+        pokemonInfo.base_experience = base_experience[i];
+        pokemonInfo.order = order[i];
+        pokemonInfo.is_default = is_default[i];
+        return pokemonInfo;
+    }
+
+    std::string toString(uint32_t i) const {
+        std::string pokemonString;
+        appendField(pokemonString, id[i]);
+        appendStringField(pokemonString, name[i]);
+        appendField(pokemonString, species_id[i]);
+        appendField(pokemonString, height[i]);
+        appendField(pokemonString, weight[i]);
+        appendField(pokemonString, base_experience[i]);
+        appendField(pokemonString, order[i]);
+        appendField(pokemonString, is_default[i], true);
+        return pokemonString;
+    }
 
-    PokemonMove(std::string pokemon_id, std::string version_group_id, std::string move_id, std::string pokemon_move_method_id,
-            std::string level, std::string order) {
-        this->pokemon_id = stoi(pokemon_id);
-        this->version_group_id = stoi(version_group_id);
-        this->move_id = stoi(move_id);
-        this->pokemon_move_method_id = stoi(pokemon_move_method_id);
-        this->level = stoi(level);
-        this->order = stoi(order);
-        pokemonMoveString = "";
-        if (this->pokemon_id != -1) {
-            pokemonMoveString += pokemon_id;
-        }
-        pokemonMoveString += ",";
-        if (this->version_group_id != -1) {
-            pokemonMoveString += version_group_id;
-        }
-        pokemonMoveString += ",";
-        if (this->move_id != -1) {
-            pokemonMoveString += move_id;
-        }
-        pokemonMoveString += ",";
-        if (this->pokemon_move_method_id != -1) {
-            pokemonMoveString += pokemon_move_method_id;
-        }
-        pokemonMoveString += ",";
-        if (this->level != -1) {
-            pokemonMoveString += level;
-        }
-        pokemonMoveString += ",";
-        if (this->order != -1) {
-            pokemonMoveString += order;
-        }
+    uint32_t size() const {
+        return id.size();
+    }
+};
+
+class MoveTable {
+public:
+    Column<int> id;
+    Column<uint32_t> name;
+    Column<int> generation_id;
+    Column<int> type_id;
+    Column<int> power;
+    Column<int> pp;
+    Column<int> accuracy;
+    Column<int> priority;
+    Column<int> target_id;
+    Column<int> damage_class_id;
+    Column<int> effect_id;
+    Column<int> effect_chance;
+    Column<int> contest_type_id;
+    Column<int> contest_effect_id;
+    Column<int> super_contest_effect_id;
+
+    template <typename F>
+    void forEachColumn(F visit) {
+        visit(id); visit(name); visit(generation_id); visit(type_id); visit(power); visit(pp); visit(accuracy);
+        visit(priority); visit(target_id); visit(damage_class_id); visit(effect_id); visit(effect_chance);
+        visit(contest_type_id); visit(contest_effect_id); visit(super_contest_effect_id);
+    }
+
+    Move row(uint32_t i) const {
+        Move move;
+        move.id = id[i];
+        move.nameOffset = name[i];
+        move.generation_id = generation_id[i];
+        move.type_id = type_id[i];
+        move.power = power[i];
+        move.pp = pp[i];
+        move.accuracy = accuracy[i];
+        move.priority = priority[i];
+        move.target_id = target_id[i];
+        move.damage_class_id = damage_class_id[i];
+        move.effect_id = effect_id[i];
+        move.effect_chance = effect_chance[i];
+        move.contest_type_id = contest_type_id[i];
+        move.contest_effect_id = contest_effect_id[i];
+        move.super_contest_effect_id = super_contest_effect_id[i];
+        return move;
+    }
+
+    std::string toString(uint32_t i) const {
+        std::string moveString;
+        appendField(moveString, id[i]);
+        appendStringField(moveString, name[i]);
+        appendField(moveString, generation_id[i]);
+        appendField(moveString, type_id[i]);
+        appendField(moveString, power[i]);
+        appendField(moveString, pp[i]);
+        appendField(moveString, accuracy[i]);
+        appendField(moveString, priority[i]);
+        appendField(moveString, target_id[i]);
+        appendField(moveString, damage_class_id[i]);
+        appendField(moveString, effect_id[i]);
+        appendField(moveString, effect_chance[i]);
+        appendField(moveString, contest_type_id[i]);
+        appendField(moveString, contest_effect_id[i]);
+        appendField(moveString, super_contest_effect_id[i], true);
+        return moveString;
+    }
+
+    uint32_t size() const {
+        return id.size();
     }
+};
 
-    std::string toString() {
+class PokemonMoveTable {
+public:
+    Column<int> pokemon_id;
+    Column<int> version_group_id;
+    Column<int> move_id;
+    Column<int> pokemon_move_method_id;
+    Column<int> level;
+    Column<int> order;
+
+    template <typename F>
+    void forEachColumn(F visit) {
+        visit(pokemon_id); visit(version_group_id); visit(move_id); visit(pokemon_move_method_id); visit(level);
+        visit(order);
+    }
+
+    std::string toString(uint32_t i) const {
+        std::string pokemonMoveString;
+        appendField(pokemonMoveString, pokemon_id[i]);
+        appendField(pokemonMoveString, version_group_id[i]);
+        appendField(pokemonMoveString, move_id[i]);
+        appendField(pokemonMoveString, pokemon_move_method_id[i]);
+        appendField(pokemonMoveString, level[i]);
+        appendField(pokemonMoveString, order[i], true);
         return pokemonMoveString;
     }
+
+    uint32_t size() const {
+        return pokemon_id.size();
+    }
 };
 
-class PokemonSpecies {
+class PokemonSpeciesTable {
 
 public:
-    int id;
-    std::string name;
-    int generation_id;
-    int evolves_from_species_id;
-    int evolution_chain_id;
-    int color_id;
-    int shape_id;
-    int habitat_id;
-    int gender_rate;
-    int capture_rate;
-    int base_happiness;
-    int is_baby;
-    int hatch_counter;
-    int has_gender_differences;
-    int growth_rate_id;
-    int forms_switchable;
-    int is_legendary;
-    int is_mythical;
-    int order;
-    int conquest_order;
-    std::string pokemonSpeciesString;
-
-    PokemonSpecies(std::string id, std::string name, std::string generation_id, std::string evolves_from_species_id,
-         std::string evolution_chain_id, std::string color_id, std::string shape_id, std::string habitat_id,
-         std::string gender_rate, std::string capture_rate, std::string base_happiness, std::string is_baby,
-         std::string hatch_counter, std::string has_gender_differences, std::string growth_rate_id,
-         std::string forms_switchable, std::string is_legendary, std::string is_mythical, std::string order,
-         std::string conquest_order) {
-        this->id = stoi(id);
-        this->name = name;
-        this->generation_id = stoi(generation_id);
-        this->evolves_from_species_id = stoi(evolves_from_species_id);
-        this->evolution_chain_id = stoi(evolution_chain_id);
-        this->color_id = stoi(color_id);
-        this->shape_id = stoi(shape_id);
-        this->habitat_id = stoi(habitat_id);
-        this->gender_rate = stoi(gender_rate);
-        this->capture_rate = stoi(capture_rate);
-        this->base_happiness = stoi(base_happiness);
-        this->is_baby = stoi(is_baby);
-        this->hatch_counter = stoi(hatch_counter);
-        this->has_gender_differences = stoi(has_gender_differences);
-        this->growth_rate_id = stoi(growth_rate_id);
-        this->forms_switchable = stoi(forms_switchable);
-        this->is_legendary = stoi(is_legendary);
-        this->is_mythical = stoi(is_mythical);
-        this->order = stoi(order);
-        this->conquest_order = stoi(conquest_order);
-        pokemonSpeciesString = "";
-        if (this->id != -1) {
-            pokemonSpeciesString += id;
-        }
-        pokemonSpeciesString += ",";
-        if (this->name != "-1") {
-            pokemonSpeciesString += name;
-        }
-        pokemonSpeciesString += ",";
-        if (this->generation_id != -1) {
-            pokemonSpeciesString += generation_id;
-        }
-        pokemonSpeciesString += ",";
-        if (this->evolves_from_species_id != -1) {
-            pokemonSpeciesString += evolves_from_species_id;
-        }
-        pokemonSpeciesString += ",";
-        if (this->evolution_chain_id != -1) {
-            pokemonSpeciesString += evolution_chain_id;
-        }
-        pokemonSpeciesString += ",";
-        if (this->color_id != -1) {
-            pokemonSpeciesString += color_id;
-        }
-        pokemonSpeciesString += ",";
-        if (this->shape_id != -1) {
-            pokemonSpeciesString += shape_id;
-        }
-        pokemonSpeciesString += ",";
-        if (this->habitat_id != -1) {
-            pokemonSpeciesString += habitat_id;
-        }
-        pokemonSpeciesString += ",";
-        if (this->gender_rate != -1) {
-            pokemonSpeciesString += gender_rate;
-        }
-        pokemonSpeciesString += ",";
-        if (this->capture_rate != -1) {
-            pokemonSpeciesString += capture_rate;
-        }
-        pokemonSpeciesString += ",";
-        if (this->base_happiness != -1) {
-            pokemonSpeciesString += base_happiness;
-        }
-        pokemonSpeciesString += ",";
-        if (this->is_baby != -1) {
-            pokemonSpeciesString += is_baby;
-        }
-        pokemonSpeciesString += ",";
-        if (this->hatch_counter != -1) {
-            pokemonSpeciesString += hatch_counter;
-        }
-        pokemonSpeciesString += ",";
-        if (this->has_gender_differences != -1) {
-            pokemonSpeciesString += has_gender_differences;
-        }
-        pokemonSpeciesString += ",";
-        if (this->growth_rate_id != -1) {
-            pokemonSpeciesString += growth_rate_id;
-        }
-        pokemonSpeciesString += ",";
-        if (this->forms_switchable != -1) {
-            pokemonSpeciesString += forms_switchable;
-        }
-        pokemonSpeciesString += ",";
-        if (this->is_legendary != -1) {
-            pokemonSpeciesString += is_legendary;
-        }
-        pokemonSpeciesString += ",";
-        if (this->is_mythical != -1) {
-            pokemonSpeciesString += is_mythical;
-        }
-        pokemonSpeciesString += ",";
-        if (this->order != -1) {
-            pokemonSpeciesString += order;
-        }
-        pokemonSpeciesString += ",";
-        if (this->conquest_order != -1) {
-            pokemonSpeciesString += conquest_order;
-        }
-    }
-
-    std::string toString() {
+    Column<int> id;
+    Column<uint32_t> name;
+    Column<int> generation_id;
+    Column<int> evolves_from_species_id;
+    Column<int> evolution_chain_id;
+    Column<int> color_id;
+    Column<int> shape_id;
+    Column<int> habitat_id;
+    Column<int> gender_rate;
+    Column<int> capture_rate;
+    Column<int> base_happiness;
+    Column<int> is_baby;
+    Column<int> hatch_counter;
+    Column<int> has_gender_differences;
+    Column<int> growth_rate_id;
+    Column<int> forms_switchable;
+    Column<int> is_legendary;
+    Column<int> is_mythical;
+    Column<int> order;
+    Column<int> conquest_order;
+
+    template <typename F>
+    void forEachColumn(F visit) {
+        visit(id); visit(name); visit(generation_id); visit(evolves_from_species_id); visit(evolution_chain_id);
+        visit(color_id); visit(shape_id); visit(habitat_id); visit(gender_rate); visit(capture_rate);
+        visit(base_happiness); visit(is_baby); visit(hatch_counter); visit(has_gender_differences);
+        visit(growth_rate_id); visit(forms_switchable); visit(is_legendary); visit(is_mythical); visit(order);
+        visit(conquest_order);
+    }
+
+    std::string toString(uint32_t i) const {
+        std::string pokemonSpeciesString;
+        appendField(pokemonSpeciesString, id[i]);
+        appendStringField(pokemonSpeciesString, name[i]);
+        appendField(pokemonSpeciesString, generation_id[i]);
+        appendField(pokemonSpeciesString, evolves_from_species_id[i]);
+        appendField(pokemonSpeciesString, evolution_chain_id[i]);
+        appendField(pokemonSpeciesString, color_id[i]);
+        appendField(pokemonSpeciesString, shape_id[i]);
+        appendField(pokemonSpeciesString, habitat_id[i]);
+        appendField(pokemonSpeciesString, gender_rate[i]);
+        appendField(pokemonSpeciesString, capture_rate[i]);
+        appendField(pokemonSpeciesString, base_happiness[i]);
+        appendField(pokemonSpeciesString, is_baby[i]);
+        appendField(pokemonSpeciesString, hatch_counter[i]);
+        appendField(pokemonSpeciesString, has_gender_differences[i]);
+        appendField(pokemonSpeciesString, growth_rate_id[i]);
+        appendField(pokemonSpeciesString, forms_switchable[i]);
+        appendField(pokemonSpeciesString, is_legendary[i]);
+        appendField(pokemonSpeciesString, is_mythical[i]);
+        appendField(pokemonSpeciesString, order[i]);
+        appendField(pokemonSpeciesString, conquest_order[i], true);
         return pokemonSpeciesString;
     }
+
+    uint32_t size() const {
+        return id.size();
+    }
 };
 
-class Experience {
+class ExperienceTable {
 public:
-    int growth_rate_id;
-    int level;
-    int experience;
-    std::string experienceString;
+    Column<int> growth_rate_id;
+    Column<int> level;
+    Column<int> experience;
 
-    Experience(std::string growth_rate_id, std::string level, std::string experience) {
-        this->growth_rate_id = stoi(growth_rate_id);
-        this->level = stoi(level);
-        this->experience = stoi(experience);
-        experienceString = "";
-        if (this->growth_rate_id != -1) {
-            experienceString += growth_rate_id;
-        }
-        experienceString += ",";
-        if (this->level != -1) {
-            experienceString += level;
-        }
-        experienceString += ",";
-        if (this->experience != -1) {
-            experienceString += experience;
-        }
+    template <typename F>
+    void forEachColumn(F visit) {
+        visit(growth_rate_id); visit(level); visit(experience);
     }
 
-    std::string toString() {
+    std::string toString(uint32_t i) const {
+        std::string experienceString;
+        appendField(experienceString, growth_rate_id[i]);
+        appendField(experienceString, level[i]);
+        appendField(experienceString, experience[i], true);
         return experienceString;
     }
+
+    uint32_t size() const {
+        return growth_rate_id.size();
+    }
 };
 
-class TypeName {
+class TypeNameTable {
 public:
-    int type_id;
-    int local_language_id;
-    std::string name;
-    std::string typeNameString;
+    Column<int> type_id;
+    Column<int> local_language_id;
+    Column<uint32_t> name;
 
-    TypeName(std::string type_id, std::string local_language_id, std::string name) {
-        this->type_id = stoi(type_id);
-        this->local_language_id = stoi(local_language_id);
-        this->name = name;
-        typeNameString = "";
-        if (this->type_id != -1) {
-            typeNameString += type_id;
-        }
-        typeNameString += ",";
-        if (this->local_language_id != -1) {
-            typeNameString += local_language_id;
-        }
-        typeNameString += ",";
-        if (this->name != "-1") {
-            typeNameString += name;
-        }
+    template <typename F>
+    void forEachColumn(F visit) {
+        visit(type_id); visit(local_language_id); visit(name);
     }
 
-    std::string toString() {
+    std::string toString(uint32_t i) const {
+        std::string typeNameString;
+        appendField(typeNameString, type_id[i]);
+        appendField(typeNameString, local_language_id[i]);
+        appendStringField(typeNameString, name[i], true);
         return typeNameString;
     }
+
+    uint32_t size() const {
+        return type_id.size();
+    }
 };
 
-class PokemonStat {
+class PokemonStatTable {
 public:
-    int pokemon_id;
-    int stat_id;
-    int base_stat;
-    int effort;
-    std::string pokemonStatString;
+    Column<int> pokemon_id;
+    Column<int> stat_id;
+    Column<int> base_stat;
+    Column<int> effort;
+
+    template <typename F>
+    void forEachColumn(F visit) {
+        visit(pokemon_id); visit(stat_id); visit(base_stat); visit(effort);
+    }
+
+    std::string toString(uint32_t i) const {
+        std::string pokemonStatString;
+        appendField(pokemonStatString, pokemon_id[i]);
+        appendField(pokemonStatString, stat_id[i]);
+        appendField(pokemonStatString, base_stat[i]);
+        appendField(pokemonStatString, effort[i], true);
+        return pokemonStatString;
+    }
 
-    PokemonStat(std::string pokemon_id, std::string stat_id, std::string base_stat, std::string effort) {
-        this->pokemon_id = stoi(pokemon_id);
-        this->stat_id = stoi(stat_id);
-        this->base_stat = stoi(base_stat);
-        this->effort = stoi(effort);
-        pokemonStatString = "";
-        if (this->pokemon_id != -1) {
-            pokemonStatString += pokemon_id;
-        }
-        pokemonStatString += ",";
-        if (this->stat_id != -1) {
-            pokemonStatString += stat_id;
+    uint32_t size() const {
+        return pokemon_id.size();
+    }
+};
+
+class PokemonTypeTable {
+public:
+    Column<int> pokemon_id;
+    Column<int> type_id;
+    Column<int> slot;
+
+    template <typename F>
+    void forEachColumn(F visit) {
+        visit(pokemon_id); visit(type_id); visit(slot);
+    }
+
+    std::string toString(uint32_t i) const {
+        std::string pokemonTypeString;
+        appendField(pokemonTypeString, pokemon_id[i]);
+        appendField(pokemonTypeString, type_id[i]);
+        appendField(pokemonTypeString, slot[i], true);
+        return pokemonTypeString;
+    }
+
+    uint32_t size() const {
+        return pokemon_id.size();
+    }
+};
+
+class TypeEfficacyTable {
+public:
+    Column<int> damage_type_id;
+    Column<int> target_type_id;
+    Column<int> damage_factor;
+
+    template <typename F>
+    void forEachColumn(F visit) {
+        visit(damage_type_id); visit(target_type_id); visit(damage_factor);
+    }
+
+    std::string toString(uint32_t i) const {
+        std::string typeEfficacyString;
+        appendField(typeEfficacyString, damage_type_id[i]);
+        appendField(typeEfficacyString, target_type_id[i]);
+        appendField(typeEfficacyString, damage_factor[i], true);
+        return typeEfficacyString;
+    }
+
+    uint32_t size() const {
+        return damage_type_id.size();
+    }
+};
+
+/*
+ * Damage multiplier of every move type against every pair of defending types, precomputed from the type efficacy table
+ * so a hit costs one lookup. Index 0 stands for no type, and for type ids outside the chart, and is always neutral.
+ */
+class TypeEfficacy {
+public:
+    //[move type][defending type]
+    float factors[TYPE_COUNT + 1][TYPE_COUNT + 1];
+    //[move type][first defending type][second defending type], the product of both factors
+    float dualFactors[TYPE_COUNT + 1][TYPE_COUNT + 1][TYPE_COUNT + 1];
+
+    TypeEfficacy() {
+        reset();
+    }
+
+    static int index(int typeID) {
+        return typeID >= 1 && typeID <= TYPE_COUNT ? typeID : 0;
+    }
+
+    void reset() {
+
+        for (int move = 0; move <= TYPE_COUNT; move++) {
+            for (int target = 0; target <= TYPE_COUNT; target++) {
+                factors[move][target] = 1;
+            }
         }
-        pokemonStatString += ",";
-        if (this->base_stat != -1) {
-            pokemonStatString += base_stat;
+        precompute();
+
+    }
+
+    void set(int moveTypeID, int targetTypeID, float factor) {
+        if (index(moveTypeID) != 0 && index(targetTypeID) != 0) {
+            factors[moveTypeID][targetTypeID] = factor;
         }
-        pokemonStatString += ",";
-        if (this->effort != -1) {
-            pokemonStatString += effort;
+    }
+
+    //fills dualFactors from factors, to be called once all factors are set
+    void precompute() {
+
+        for (int move = 0; move <= TYPE_COUNT; move++) {
+            for (int first = 0; first <= TYPE_COUNT; first++) {
+                for (int second = 0; second <= TYPE_COUNT; second++) {
+                    dualFactors[move][first][second] = factors[move][first] * factors[move][second];
+                }
+            }
         }
+
     }
 
-    std::string toString() {
-        return pokemonStatString;
+    //typeID2 is -1 or 0 for a pokemon with a single type
+    double against(int moveTypeID, int typeID1, int typeID2) const {
+        return dualFactors[index(moveTypeID)][index(typeID1)][index(typeID2)];
     }
 };
 
-class PokemonType {
+/*
+ * Moves addressed directly by move id. Ids without a move hold a sentinel move with every field null, which is also what any id
+ * out of range resolves to, so looking a move up never searches or fails.
+ */
+class MoveRegistry {
 public:
-    int pokemon_id;
-    int type_id;
-    int slot;
-    std::string pokemonTypeString;
+    //index = move id, index 0 is never a move id and holds the sentinel
+    std::vector<Move> moves;
 
-    PokemonType(std::string pokemon_id, std::string type_id, std::string slot) {
-        this->pokemon_id = stoi(pokemon_id);
-        this->type_id = stoi(type_id);
-        this->slot = stoi(slot);
-        pokemonTypeString = "";
-        if (this->pokemon_id != -1) {
-            pokemonTypeString += pokemon_id;
-        }
-        pokemonTypeString += ",";
-        if (this->type_id != -1) {
-            pokemonTypeString += type_id;
-        }
-        pokemonTypeString += ",";
-        if (this->slot != -1) {
-            pokemonTypeString += slot;
+    const Move &get(int moveID) const {
+        return moves[(uint32_t) moveID < moves.size() ? moveID : 0];
+    }
+
+    bool contains(int moveID) const {
+        return get(moveID).id != POKEDEX_NULL;
+    }
+
+    //registers a move that is not in the moves table under the next free id
+    int add(Move move) {
+        move.id = moves.size();
+        moves.push_back(move);
+        return move.id;
+    }
+};
+
+MoveRegistry moveRegistry;
+
+/*
+ * A level up move of a pokemon and the level it is learned at.
+ */
+struct LevelUpMove {
+    int move_id;
+    int level;
+};
+
+/*
+ * Everything create_pokemon needs about one pokemon, gathered from the pokedex tables once at load time.
+ */
+struct PokemonIndexEntry {
+    PokemonInfo info;
+    //slice of PokemonIndex::levelUpMoves, sorted by level with each move listed once
+    uint32_t firstLevelUpMove;
+    uint32_t levelUpMoveCount;
+    //indexed by stat id - 1: health, attack, defense, special attack, special defense, speed
+    int baseStats[6];
+    //by slot, -1 if the pokemon has a single type
+    int typeIDs[2];
+};
+
+class PokemonIndex {
+public:
+    //one entry per row of allPokemonInfo, in the same order, then those added
+    std::vector<PokemonIndexEntry> entries;
+    std::vector<LevelUpMove> levelUpMoves;
+    //pokemon id -> position in entries, -1 for ids without a pokemon
+    std::vector<int> entryByID;
+
+    //@return position in entries of the pokemon with pokemonID, -1 if there is none
+    int speciesOf(int pokemonID) const {
+        if (pokemonID < 0 || pokemonID >= (int) entryByID.size()) {
+            return -1;
         }
+        return entryByID[pokemonID];
     }
 
-    std::string toString() {
-        return pokemonTypeString;
+    PokemonIndexEntry *find(int pokemonID) {
+        int species = speciesOf(pokemonID);
+        return species == -1 ? NULL : &entries[species];
+    }
+
+    //registers a pokemon that is not in the pokemon table, without types or level up moves, and returns its position
+    int add(const PokemonInfo &info, const int baseStats[6]) {
+        PokemonIndexEntry entry = {info, 0, 0, {0, 0, 0, 0, 0, 0}, {-1, -1}};
+        memcpy(entry.baseStats, baseStats, sizeof(entry.baseStats));
+        entries.push_back(entry);
+        return entries.size() - 1;
     }
 };
 
+PokemonIndex pokemonIndex;
+
+//stats in the order of PokemonStats, PokemonIndexEntry::baseStats and the IVs packed in Pokemon::ivs
+enum pokemon_stat {STAT_HEALTH, STAT_ATTACK, STAT_DEFENSE, STAT_SPECIAL_ATTACK, STAT_SPECIAL_DEFENSE, STAT_SPEED};
+
+/*
+ * Stats of a pokemon worked out from its base stats, IVs and level.
+ */
+struct PokemonStats {
+    uint16_t health;
+    uint16_t attack;
+    uint16_t defense;
+    uint16_t specialAttack;
+    uint16_t specialDefense;
+    uint16_t speed;
+};
+
+/*
+ * A pokemon as plain data: species data is looked up in pokemonIndex by position, and moves and types are held inline,
+ * so pokemon are copied freely, kept by value in parties and never allocated on their own.
+ */
 class Pokemon {
 public:
-    PokemonInfo *pokemonInfo;
-    int base_health;
-    int base_attack;
-    int base_defense;
-    int base_special_attack;
-    int base_special_defense;
-    int base_speed;
-    int health_iv = rand() % 16;
-    int attack_iv = rand() % 16;
-    int defense_iv = rand() % 16;
-    int special_attack_iv = rand() % 16;
-    int special_defense_iv = rand() % 16;
-    int speed_iv = rand() % 16;
-    int level;
-    int experience;
-    int maxHealth;
-    int health;
-    //must have between 1 and 4 moves (2 on creation if possible, 1 is always possible if not 2)
-    std::vector<Move *> moves;
-    std::vector<int> typeIDs;
+    //position of the entry of the pokemon in pokemonIndex.entries
+    uint16_t species;
+    uint8_t level;
+    //between 1 and 4 (2 on creation if possible, 1 is always possible if not 2)
+    uint8_t moveCount;
+    //by move id, the first moveCount are known
+    uint16_t moves[4];
+    //by slot, 0 if the pokemon has a single type
+    uint16_t typeIDs[2];
     bool male;
     bool shiny;
-    bool knockedOut = false;
-
-    Pokemon(PokemonInfo *pokemonInfo, int base_health, int base_attack, int base_defense, int base_speed,
-            int base_special_attack, int base_special_defense, int level, std::vector<Move *> moves, bool male,
-            bool shiny) :
-            pokemonInfo(pokemonInfo), base_health(base_health), base_attack(base_attack), base_defense(base_defense),
-            base_speed(base_speed), base_special_attack(base_special_attack), base_special_defense(base_special_defense),
-            level(level), moves(moves), male(male), shiny(shiny) {
+    bool knockedOut;
+    //4 bits per IV, by pokemon_stat from the lowest bits
+    uint32_t ivs;
+    int32_t experience;
+    //starts at stats.health and grows with it on level ups, but can be raised past it
+    int32_t maxHealth;
+    int32_t health;
+    //derived from the base stats of the species, the IVs and level by updateStats, which anything changing them calls
+    PokemonStats stats;
+
+    Pokemon() = default;
+
+    //draws IVs, then starts at level with no experience and full health
+    Pokemon(int species, int level, const std::vector<int> &moves, bool male, bool shiny) :
+            species(species), level(level), male(male), shiny(shiny), knockedOut(false) {
+        learnSpecies(moves);
+        rollIVs();
+        restore(level);
+    }
+
+    //as it was stored, without drawing anything, ivs packed as in Pokemon::ivs
+    Pokemon(int species, int level, const std::vector<int> &moves, bool male, bool shiny, uint32_t ivs,
+            int experience, int maxHealth, int health, bool knockedOut) :
+            species(species), level(level), male(male), shiny(shiny), knockedOut(knockedOut), ivs(ivs),
+            experience(experience), maxHealth(maxHealth), health(health) {
+        learnSpecies(moves);
+        updateStats();
+    }
+
+    const PokemonIndexEntry &entry() const {
+        return pokemonIndex.entries[species];
+    }
+
+    const PokemonInfo &info() const {
+        return entry().info;
+    }
+
+    //back to level with no experience and full health, as when created
+    void restore(int level) {
+        this->level = level;
+        updateStats();
         this->experience = 0;
-        this->maxHealth = ((base_health + health_iv) * 2 * level) / 100 + level + 10;
+        this->maxHealth = stats.health;
         this->health = maxHealth;
+        this->knockedOut = false;
+    }
+
+    //draws new IVs, in the order of pokemon_stat
+    void rollIVs() {
+        uint32_t ivs = 0;
+        for (int stat = STAT_HEALTH; stat <= STAT_SPEED; stat++) {
+            ivs |= (uint32_t) random_below(16) << (4 * stat);
+        }
+        this->ivs = ivs;
+        updateStats();
+    }
+
+    //@return ivs, by pokemon_stat, packed as in Pokemon::ivs
+    static uint32_t packIVs(const uint8_t ivs[6]) {
+        uint32_t packed = 0;
+        for (int stat = STAT_HEALTH; stat <= STAT_SPEED; stat++) {
+            packed |= (uint32_t) (ivs[stat] & 15) << (4 * stat);
+        }
+        return packed;
+    }
+
+    int getIV(enum pokemon_stat stat) const {
+        return (ivs >> (4 * stat)) & 15;
+    }
+
+    void updateStats() {
+        const int *base = entry().baseStats;
+        stats.health = ((base[STAT_HEALTH] + getIV(STAT_HEALTH)) * 2 * level) / 100 + level + 10;
+        stats.attack = ((base[STAT_ATTACK] + getIV(STAT_ATTACK)) * 2 * level) / 100 + 5;
+        stats.defense = ((base[STAT_DEFENSE] + getIV(STAT_DEFENSE)) * 2 * level) / 100 + 5;
+        stats.specialAttack = ((base[STAT_SPECIAL_ATTACK] + getIV(STAT_SPECIAL_ATTACK)) * 2 * level) / 100 + 5;
+        stats.specialDefense = ((base[STAT_SPECIAL_DEFENSE] + getIV(STAT_SPECIAL_DEFENSE)) * 2 * level) / 100 + 5;
+        stats.speed = ((base[STAT_SPEED] + getIV(STAT_SPEED)) * 2 * level) / 100 + 5;
+    }
+
+    const Move &getMove(int i) const {
+        return moveRegistry.get(moves[i]);
+    }
+
+    //takes up to 4 of moves and the types of the species
+    void learnSpecies(const std::vector<int> &moves) {
+        moveCount = 0;
+        memset(this->moves, 0, sizeof(this->moves));
+        for (int i = 0; i < (int) moves.size() && moveCount < 4; i++) {
+            this->moves[moveCount++] = moves[i];
+        }
+        for (int i = 0; i < 2; i++) {
+            typeIDs[i] = entry().typeIDs[i] == -1 ? 0 : entry().typeIDs[i];
+        }
+    }
+
+    bool hasType(int typeID) const {
+        return typeID != 0 && (typeIDs[0] == typeID || typeIDs[1] == typeID);
     }
 
     int getHealth() {
         return health;
     }
 
-    int getAttack() {
-        return ((base_attack + attack_iv) * 2 * level) / 100 + 5;
+    int getAttack() const {
+        return stats.attack;
     }
 
-    int getDefense() {
-        return ((base_defense + defense_iv) * 2 * level) / 100 + 5;
+    int getDefense() const {
+        return stats.defense;
     }
 
-    int getSpecialAttack() {
-        return ((base_special_attack + special_attack_iv) * 2 * level) / 100 + 5;
+    int getSpecialAttack() const {
+        return stats.specialAttack;
     }
 
-    int getSpecialDefense() {
-        return ((base_special_defense + special_defense_iv) * 2 * level) / 100 + 5;
+    int getSpecialDefense() const {
+        return stats.specialDefense;
     }
 
-    int getSpeed() {
-        return ((base_speed + speed_iv) * 2 * level) / 100 + 5;
+    int getSpeed() const {
+        return stats.speed;
     }
 
+    //max health and, unless knocked out, health grow by as much as the health stat does on a level up
     bool gainExperience(int amount) {
         this->experience += amount;
         bool levelUp = false;
-        //todo: update max health and current health
         while (level + 1 <= MAXIMUM_LEVEL && experience > levelUpExperienceCost[level + 1]) {
             level++;
             levelUp = true;
         }
+        if (levelUp) {
+            int previousHealth = stats.health;
+            updateStats();
+            maxHealth += stats.health - previousHealth;
+            if (!knockedOut) {
+                health += stats.health - previousHealth;
+            }
+        }
         return levelUp;
     }
 
@@ -687,6 +1167,49 @@ public:
 
 };
 
+static_assert(std::is_trivially_copyable<Pokemon>::value && sizeof(Pokemon) <= 64,
+              "pokemon must stay small plain data");
+
+/*
+ * Up to PARTY_SIZE pokemon held by value, so a party copies as a whole and pointers into it stay valid.
+ */
+class Party {
+public:
+    Pokemon members[PARTY_SIZE];
+    int count;
+
+    Party() : count(0) {}
+
+    int size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    bool full() const {
+        return count == PARTY_SIZE;
+    }
+
+    Pokemon &at(int i) {
+        return members[i];
+    }
+
+    const Pokemon &at(int i) const {
+        return members[i];
+    }
+
+    //@return false if the party is full
+    bool push_back(const Pokemon &pokemon) {
+        if (full()) {
+            return false;
+        }
+        members[count++] = pokemon;
+        return true;
+    }
+};
+
 class Bag{
 public:
     int numPotions;
@@ -694,11 +1217,14 @@ public:
     int numPokeballs;
 
     Bag() {
-        this->numPotions = 3 + rand() % 3;
-        this->numRevives = 1 + rand() % 2;
-        this->numPokeballs = 1 + rand() % 2;
+        this->numPotions = 3 + random_below(3);
+        this->numRevives = 1 + random_below(2);
+        this->numPokeballs = 1 + random_below(2);
     }
 
+    Bag(int numPotions, int numRevives, int numPokeballs) : numPotions(numPotions), numRevives(numRevives),
+                                                            numPokeballs(numPokeballs) {}
+
     int usePotion(Pokemon *pokemon) {
         if (numPotions > 0) {
             pokemon->heal(20);
@@ -725,9 +1251,9 @@ public:
         }
     }
 
-    int usePokeball(std::vector<Pokemon *> pokemon) {
+    int usePokeball(const Party &party) {
         if (numPokeballs > 0) {
-            if (pokemon.size() < 6) {
+            if (!party.full()) {
                 return 0;
             } else {
                 return 2;
@@ -740,6 +1266,58 @@ public:
 
 };
 
+/*
+ * Something that happened in a battle. pokemon is the one it happened to: the attacker for BATTLE_MOVE_USED,
+ * BATTLE_EXPERIENCE and BATTLE_LEVEL_UP, the defender for BATTLE_DAMAGE, BATTLE_MISSED and BATTLE_FAINTED.
+ */
+struct BattleEvent {
+    enum battle_event_type type;
+    Pokemon *pokemon;
+    //the move used for BATTLE_MOVE_USED
+    int moveID;
+    //damage taken, experience gained or level reached
+    int amount;
+    //type multiplier of the damage
+    double effectiveness;
+    //of pokemon once the event happened
+    int health;
+    int maxHealth;
+};
+
+/*
+ * Events of a battle turn in order. The battle core only records what happens here and screens render it afterwards,
+ * so battles run without a terminal. Fixed capacity so logging never allocates.
+ */
+class BattleLog {
+public:
+    //one more than kept, the last taking the events of a full log, which are dropped
+    BattleEvent events[BATTLE_LOG_CAPACITY + 1];
+    int size;
+
+    BattleLog() : size(0) {}
+
+    void clear() {
+        size = 0;
+    }
+
+    /*
+     * @return the event to fill in, which is dropped if the log is full
+     */
+    BattleEvent &add(enum battle_event_type type, Pokemon *pokemon) {
+
+        BattleEvent &event = size < BATTLE_LOG_CAPACITY ? events[size++] : events[BATTLE_LOG_CAPACITY];
+        event.type = type;
+        event.pokemon = pokemon;
+        event.moveID = -1;
+        event.amount = 0;
+        event.effectiveness = 1;
+        event.health = pokemon->health;
+        event.maxHealth = pokemon->maxHealth;
+        return event;
+
+    }
+};
+
 class Character {
 public:
     int x;
@@ -755,15 +1333,19 @@ public:
     int in_building;
     int defeated;
     //always between 1 and 6 active pokemon (starts with 1 on PC creation, chance for more for trainers)
-    std::vector<Pokemon *> activePokemon;
+    Party activePokemon;
     Bag *bag;
+    //next character in the same turn scheduler bucket
+    Character *next_turn;
 
+    //takes bag, or gets a new bag of random items without one
     Character(int x, int y, enum  character_type type_enum, std::string type_string, char printable_character, int color,
-              int turn, int direction_set, int x_direction, int y_direction, int in_building, int defeated) : x(x), y(y),
-              type_enum(type_enum), type_string(type_string), printable_character(printable_character), color(color),
-              turn(turn), direction_set(direction_set), x_direction(x_direction), y_direction(y_direction),
-              in_building(in_building), defeated(defeated) {
-        bag = new Bag();
+              int turn, int direction_set, int x_direction, int y_direction, int in_building, int defeated,
+              Bag *bag = NULL) : x(x), y(y), type_enum(type_enum), type_string(type_string),
+              printable_character(printable_character), color(color), turn(turn), direction_set(direction_set),
+              x_direction(x_direction), y_direction(y_direction), in_building(in_building), defeated(defeated),
+              next_turn(NULL) {
+        this->bag = bag != NULL ? bag : new Bag();
     }
 };
 
@@ -775,39 +1357,268 @@ class NonPlayerCharacter : public Character {
 
 };
 
-class Point {
+static int32_t comparator_character_movement(const void *key, const void *with) {
+    return ((Character *) key)->turn - ((Character *) with)->turn;
+}
+
+/*
+ * Characters in order of turn. A timing wheel with a bucket per turn for the next TURN_WHEEL_SLOTS turns, linked
+ * through the characters themselves, so inserting and taking the next character are O(1) and never allocate.
+ * Characters further ahead wait in an overflow list until the wheel gets near them.
+ */
+class TurnScheduler {
 public:
-    int x;
-    int y;
-    Terrain terrain;
-    //for looped non-queue plant_seeds growth
-    Terrain grow_into;
-    Character *character;
-    int distance;
-    heap_node_t *heap_node;
-
-    Point() {
-        this->x = -1;
-        this->y = -1;
-        this->terrain = *none;
-        this->grow_into = *none;
-        this->character = NULL;
-        this->distance = INT_MAX;
-        this->heap_node = NULL;
+    Character *head[TURN_WHEEL_SLOTS];
+    Character *tail[TURN_WHEEL_SLOTS];
+    //bit per non empty bucket
+    uint64_t occupied;
+    Character *overflow;
+    int overflow_min;
+    //no character is scheduled before this turn, which is the one in bucket now % TURN_WHEEL_SLOTS
+    int now;
+    uint32_t size;
+
+    TurnScheduler() {
+        clear();
+    }
+
+    void clear() {
+
+        memset(head, 0, sizeof(head));
+        memset(tail, 0, sizeof(tail));
+        occupied = 0;
+        overflow = NULL;
+        overflow_min = INT_MAX;
+        now = INT_MIN;
+        size = 0;
+
+    }
+
+    void insert(Character *character) {
+
+        if (size == 0) {
+            now = character->turn;
+        }
+        else if (character->turn < now) {
+            rewind(character->turn);
+        }
+        size++;
+        place(character);
+
+    }
+
+    /*
+     * Puts character in the bucket of its turn, or in the overflow list when that is too far ahead.
+     */
+    void place(Character *character) {
+
+        character->next_turn = NULL;
+        int turn = character->turn;
+        if ((int64_t) turn - now >= TURN_WHEEL_SLOTS) {
+            character->next_turn = overflow;
+            overflow = character;
+            if (turn < overflow_min) {
+                overflow_min = turn;
+            }
+            return;
+        }
+        int slot = turn & (TURN_WHEEL_SLOTS - 1);
+        if (head[slot] == NULL) {
+            head[slot] = character;
+            occupied |= 1ULL << slot;
+        }
+        else {
+            tail[slot]->next_turn = character;
+        }
+        tail[slot] = character;
+
+    }
+
+    /*
+     * @return the character with the lowest turn, NULL if there is none
+     */
+    Character *pop() {
+
+        if (size == 0) {
+            return NULL;
+        }
+        if (occupied == 0) {
+            //only characters far ahead are left: jump to the nearest
+            now = overflow_min;
+        }
+        if (overflow != NULL && (int64_t) overflow_min - now < TURN_WHEEL_SLOTS) {
+            refill();
+        }
+        int slot = now & (TURN_WHEEL_SLOTS - 1);
+        //rotate so the bucket of now is bit 0, then the lowest set bit is the next turn
+        uint64_t rotated = (occupied >> slot) | (slot == 0 ? 0 : occupied << (TURN_WHEEL_SLOTS - slot));
+        now += __builtin_ctzll(rotated);
+        slot = now & (TURN_WHEEL_SLOTS - 1);
+        Character *character = head[slot];
+        head[slot] = character->next_turn;
+        if (head[slot] == NULL) {
+            occupied &= ~(1ULL << slot);
+        }
+        character->next_turn = NULL;
+        size--;
+        return character;
+
+    }
+
+    /*
+     * Moves the overflow characters the wheel has come near into their buckets.
+     */
+    void refill() {
+
+        Character *waiting = overflow;
+        overflow = NULL;
+        overflow_min = INT_MAX;
+        while (waiting != NULL) {
+            Character *next = waiting->next_turn;
+            place(waiting);
+            waiting = next;
+        }
+
+    }
+
+    /*
+     * Moves the wheel back to start at turn, for a character scheduled before any other. Buckets that no longer fit
+     * in the wheel go to the overflow list.
+     */
+    void rewind(int turn) {
+
+        uint64_t remaining = occupied;
+        while (remaining != 0) {
+            int slot = __builtin_ctzll(remaining);
+            remaining &= remaining - 1;
+            int bucket_turn = now + ((slot - now) & (TURN_WHEEL_SLOTS - 1));
+            if ((int64_t) bucket_turn - turn >= TURN_WHEEL_SLOTS) {
+                tail[slot]->next_turn = overflow;
+                overflow = head[slot];
+                if (bucket_turn < overflow_min) {
+                    overflow_min = bucket_turn;
+                }
+                head[slot] = NULL;
+                occupied &= ~(1ULL << slot);
+            }
+        }
+        now = turn;
+
     }
 };
 
-static int32_t comparator_trainer_distance_tile(const void *key, const void *with) {
-    return ((Point *) key)->distance - ((Point *) with)->distance;
-}
+//steps to the 8 neighbors of a cell, in the order of the bits of a direction mask, so opposite directions add up to 7
+static const int direction_x[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+static const int direction_y[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+
+int direction_of(int x_direction, int y_direction) {
+
+    int index = (y_direction + 1) * 3 + x_direction + 1;
+    return index < 4 ? index : index - 1;
 
-static int32_t comparator_character_movement(const void *key, const void *with) {
-    return ((Character *) key)->turn - ((Character *) with)->turn;
 }
 
+/*
+ * Distance fields of a tile by PC cell and trainer type, so a PC walking back over cells it just left reuses them. The
+ * least recently used field is replaced once all entries are taken. Distances are stored as uint16_t, UINT16_MAX where
+ * the trainer cannot get to the PC, which holds any path across a tile.
+ */
+class DistanceCache {
+public:
+    struct Entry {
+        uint16_t cell;
+        enum character_type type;
+        uint32_t used;
+        uint16_t distances[TILE_LENGTH_Y][TILE_WIDTH_X];
+    };
+
+    //allocated on first store and dropped by release, so tiles the PC is not on keep no fields
+    std::vector<Entry> entries;
+    uint32_t clock;
+    long hits;
+    long misses;
+
+    DistanceCache() : clock(0), hits(0), misses(0) {}
+
+    /*
+     * Copies the field of trainer type to x, y into distances.
+     * @return true if it was cached
+     */
+    bool load(enum character_type type, int x, int y, int distances[TILE_LENGTH_Y][TILE_WIDTH_X]) {
+
+        uint16_t cell = (uint16_t) (y * TILE_WIDTH_X + x);
+        for (Entry &entry : entries) {
+            if (entry.cell == cell && entry.type == type) {
+                entry.used = ++clock;
+                for (int i = 0; i < TILE_LENGTH_Y; i++) {
+                    for (int j = 0; j < TILE_WIDTH_X; j++) {
+                        distances[i][j] = entry.distances[i][j] == UINT16_MAX ? INT_MAX : entry.distances[i][j];
+                    }
+                }
+                hits++;
+                return true;
+            }
+        }
+        misses++;
+        return false;
+
+    }
+
+    void store(enum character_type type, int x, int y, int distances[TILE_LENGTH_Y][TILE_WIDTH_X]) {
+
+        if (entries.capacity() == 0) {
+            entries.reserve(DISTANCE_CACHE_ENTRIES);
+        }
+        Entry *entry;
+        if (entries.size() < DISTANCE_CACHE_ENTRIES) {
+            entries.emplace_back();
+            entry = &entries.back();
+        }
+        else {
+            entry = &entries[0];
+            for (Entry &candidate : entries) {
+                if (candidate.used < entry->used) {
+                    entry = &candidate;
+                }
+            }
+        }
+        entry->cell = (uint16_t) (y * TILE_WIDTH_X + x);
+        entry->type = type;
+        entry->used = ++clock;
+        for (int i = 0; i < TILE_LENGTH_Y; i++) {
+            for (int j = 0; j < TILE_WIDTH_X; j++) {
+                entry->distances[i][j] = distances[i][j] == INT_MAX ? UINT16_MAX : (uint16_t) distances[i][j];
+            }
+        }
+
+    }
+
+    //to be called whenever terrain changes, since every field depends on it
+    void invalidate() {
+        entries.clear();
+    }
+
+    void release() {
+        std::vector<Entry>().swap(entries);
+    }
+};
+
+/*
+ * A map of the world. Cells only store the id of their terrain in terrains and which character is on them, so a tile is
+ * a few KB and terrain scans stay in cache.
+ */
 class Tile {
 public:
-    Point tile[TILE_LENGTH_Y][TILE_WIDTH_X];
+    uint8_t terrain[TILE_LENGTH_Y][TILE_WIDTH_X];
+    //one bit per cell on a border between terrains, where path_weight is TERRAIN_BORDER_WEIGHT instead
+    uint32_t border[TILE_LENGTH_Y][TILE_BORDER_WORDS];
+    //1 + index in characters of the character on each cell, 0 if there is none
+    uint8_t occupant[TILE_LENGTH_Y][TILE_WIDTH_X];
+    //one bit per cell walking trainers may stand on: off the border, where rival_weight is not INT_MAX
+    uint32_t passable[TILE_LENGTH_Y][TILE_BORDER_WORDS];
+    //one bit per cell with a character on it
+    uint32_t occupied[TILE_LENGTH_Y][TILE_BORDER_WORDS];
+    std::vector<Character *> characters;
     int x;
     int y;
     int north_x;
@@ -815,8 +1626,19 @@ public:
     int east_y;
     int west_y;
     PlayerCharacter *player_character;
+    //whether the PC has been on this tile, before which it is exactly as create_tile generates it
+    bool visited;
+    //turn order of the trainers, kept while the PC is away and caught up when it comes back
+    TurnScheduler scheduler;
+    //trainer distance fields for the cells the PC was on, only kept while it is on the tile
+    DistanceCache distances;
 
     Tile() {
+        memset(this->terrain, 0, sizeof(this->terrain));
+        memset(this->border, 0, sizeof(this->border));
+        memset(this->occupant, 0, sizeof(this->occupant));
+        memset(this->passable, 0, sizeof(this->passable));
+        memset(this->occupied, 0, sizeof(this->occupied));
         this->x = -1;
         this->y = -1;
         this->north_x = -1;
@@ -824,6 +1646,113 @@ public:
         this->east_y = -1;
         this->west_y = -1;
         this->player_character = NULL;
+        this->visited = false;
+    }
+
+    const Terrain &terrain_at(int x, int y) const {
+        return terrains[terrain[y][x]];
+    }
+
+    int path_weight_at(int x, int y) const {
+        if (border[y][x / 32] & (1u << (x % 32))) {
+            return TERRAIN_BORDER_WEIGHT;
+        }
+        return terrains[terrain[y][x]].path_weight;
+    }
+
+    void set_border(int x, int y) {
+        border[y][x / 32] |= 1u << (x % 32);
+    }
+
+    //overwriting a cell's terrain also drops its border weight
+    void set_terrain(int x, int y, int id) {
+        terrain[y][x] = (uint8_t) id;
+        border[y][x / 32] &= ~(1u << (x % 32));
+    }
+
+    Character *character_at(int x, int y) const {
+        return occupant[y][x] == 0 ? NULL : characters[occupant[y][x] - 1];
+    }
+
+    void set_character(int x, int y, Character *character) {
+        if (character == NULL) {
+            occupant[y][x] = 0;
+            occupied[y][x / 32] &= ~(1u << (x % 32));
+            return;
+        }
+        //characters keep their slot when they move or leave, so the player re-entering a tile reuses theirs
+        size_t slot = std::find(characters.begin(), characters.end(), character) - characters.begin();
+        if (slot == characters.size()) {
+            characters.push_back(character);
+        }
+        occupant[y][x] = (uint8_t) (slot + 1);
+        occupied[y][x / 32] |= 1u << (x % 32);
+    }
+
+    //moves the character on x, y to the free cell new_x, new_y without looking it up in characters
+    void move_occupant(int x, int y, int new_x, int new_y) {
+        occupant[new_y][new_x] = occupant[y][x];
+        occupant[y][x] = 0;
+        occupied[y][x / 32] &= ~(1u << (x % 32));
+        occupied[new_y][new_x / 32] |= 1u << (new_x % 32);
+    }
+
+    //to be called once terrain is final and again whenever it changes
+    void update_passable() {
+        distances.invalidate();
+        memset(passable, 0, sizeof(passable));
+        for (int i = 1; i < TILE_LENGTH_Y - 1; i++) {
+            for (int j = 1; j < TILE_WIDTH_X - 1; j++) {
+                if (terrains[terrain[i][j]].rival_weight != INT_MAX) {
+                    passable[i][j / 32] |= 1u << (j % 32);
+                }
+            }
+        }
+    }
+
+    //bits x - 1, x and x + 1 of a row of one bit per cell, x not on the border
+    static uint32_t row_bits(const uint32_t row[TILE_BORDER_WORDS], int x) {
+        int word = (x - 1) / 32;
+        uint64_t bits = row[word];
+        if (word + 1 < TILE_BORDER_WORDS) {
+            bits |= (uint64_t) row[word + 1] << 32;
+        }
+        return (uint32_t) (bits >> ((x - 1) % 32)) & 7;
+    }
+
+    /*
+     * @return bit d set for each direction d a walking trainer of type on x, y may step in: onto a free cell it may walk
+     * on, or onto the PC when to_player
+     */
+    uint8_t walker_moves(enum character_type type, int x, int y, bool to_player) const {
+        uint32_t legal[3];
+        uint32_t taken[3];
+        for (int i = 0; i < 3; i++) {
+            taken[i] = row_bits(occupied[y - 1 + i], x);
+            if (type == WANDERER) {
+                //wanderers keep to the terrain they are on
+                legal[i] = 0;
+                for (int j = 0; j < 3; j++) {
+                    int cell_x = x - 1 + j;
+                    int cell_y = y - 1 + i;
+                    if (cell_x > 0 && cell_x < TILE_WIDTH_X - 1 && cell_y > 0 && cell_y < TILE_LENGTH_Y - 1
+                        && terrain[cell_y][cell_x] == terrain[y][x]) {
+                        legal[i] |= 1u << j;
+                    }
+                }
+            }
+            else {
+                legal[i] = row_bits(passable[y - 1 + i], x);
+            }
+        }
+        if (to_player && player_character != NULL && abs(player_character->x - x) <= 1
+            && abs(player_character->y - y) <= 1) {
+            taken[player_character->y - y + 1] &= ~(1u << (player_character->x - x + 1));
+        }
+        uint32_t above = legal[0] & ~taken[0];
+        uint32_t level = legal[1] & ~taken[1];
+        uint32_t below = legal[2] & ~taken[2];
+        return (uint8_t) (above | (level & 1) << 3 | (level & 4) << 2 | below << 5);
     }
 };
 
@@ -831,14 +1760,15 @@ int rival_distance_tile[TILE_LENGTH_Y][TILE_WIDTH_X];
 int hiker_distance_tile [TILE_LENGTH_Y][TILE_WIDTH_X];
 
 int print_usage();
-int storePokemon();
-int storeMoves();
-int storePokemonMoves();
-int storePokemonSpecies();
-int storeExperience();
-int storeTypeNames();
-int storePokemonStats();
-int storePokemonTypes();
+int storePokedexTables(int results[POKEDEX_TABLES]);
+int runBenchmark(const std::string &name);
+int pokedexTableIndex(const std::string &name);
+int dumpPokedexTable(int table, int argc, char *argv[]);
+int indexMoves();
+int indexPokemon();
+int indexTypeEfficacy();
+int compilePokedexSnapshot();
+int loadPokedexSnapshot();
 //commented due to database info failing to make
 //int printData(std::vector<DatabaseInfo *> dataVector);
 int story_intro();
@@ -846,15 +1776,22 @@ int cheat_toggle_question();
 int turn_based_movement();
 int player_turn();
 int move_character(int x, int y, int new_x, int new_y);
+int move_trainer(Tile *tile, Character *character);
+int pick_direction(uint8_t moves);
+int walker_step(const Tile *tile, enum character_type type, int x, int y, int &heading, bool defeated);
+int catch_up_tile(Tile *tile, int turn);
 int combat_trainer(Character *opponent);
 int bossDialog();
 int bossBattleFinished(bool victory);
-Pokemon * create_pokemon();
+Pokemon create_pokemon(int tile_x, int tile_y);
+Pokemon create_pokemon_of(int species, int level, const std::vector<int> &moves);
 int combat_pokemon(Pokemon *wildPokemon);
 int getWildPokemonMove(Pokemon *wildPokemon);
 int doCombat(Pokemon *friendlyPokemon, int friendlyPokemonMoveIndex, Pokemon *enemyPokemon, int enemyPokemonMoveIndex,
-             bool trainerBattle);
-int attack(Pokemon *attackingPokemon, int moveIndex, Pokemon *defendingPokemon, bool trainerBattle);
+             bool trainerBattle, BattleLog &log);
+int attack(Pokemon *attackingPokemon, int moveIndex, Pokemon *defendingPokemon, bool trainerBattle, BattleLog &log);
+int attemptRun(Pokemon *characterPokemon, Pokemon *wildPokemon, int numAttempts, BattleLog &log);
+int renderBattleLog(const BattleLog &log);
 int awaitInputEscape();
 int fight_action(Pokemon *selectedPokemon);
 Pokemon *switch_pokemon_action(Pokemon *selectedPokemon, bool mustSwitch);
@@ -862,19 +1799,31 @@ int bag_action(bool wildPokemonBattle, Pokemon *selectedPokemon, Pokemon *enemyP
 int usePokeball(bool success, Pokemon *targetPokemon);
 int run_action(Pokemon *characterPokemon, Pokemon *wildPokemon, int numAttempts);
 int levelUp(Pokemon *pokemon);
+int parseBattleParty(int argc, char *argv[], int &argument, Party &party);
+int estimateBattles(int argc, char *argv[]);
 int enter_center();
 int enter_mart();
-int change_tile(int x, int y);
+int change_tile(int x, int y, int entry_x, int entry_y);
+int nearest_free_cell(const Tile *tile, int &x, int &y);
 Tile create_tile(int x, int y);
 Tile create_empty_tile();
 int generate_terrain(Tile *tile);
-int plant_seeds(Tile *tile, Terrain terrain, int num_seeds);
+int plant_seeds(Tile *tile, int terrain, int num_seeds);
 int grow_seeds(Tile *tile);
+uint8_t neighbor_scan_terrain(Tile *tile, int x, int y);
+int grow_seeds_fixed_point(Tile *tile);
+int benchmark_grow_seeds(int num_tiles);
+int benchmark_turns(int num_characters, int num_turns);
+int benchmark_heap(int num_keys, int rounds);
+int benchmark_queues(int num_tiles, int num_characters, int num_turns);
+int benchmark_walkers(int num_tiles, int num_turns);
+int benchmark_distances(int num_tiles, int num_moves);
+int benchmark_distance_cache(int num_tiles, int num_moves);
 int place_edge(Tile *tile);
 int set_terrain_border_weights(Tile *tile);
 int generate_paths(Tile *tile, int north_x, int south_x, int east_y, int west_y);
 int generate_buildings(Tile *tile, int x, int y);
-int place_building(Tile *tile, Terrain terrain, double chance);
+int place_building(Tile *tile, int terrain, double chance);
 int place_final_boss(Tile *tile);
 int place_player_character(Tile *tile);
 int select_pokemon(Character *playerCharacter);
@@ -882,11 +1831,420 @@ int select_pokemon_cheating(Character *playerCharacter);
 int place_trainers(Tile *tile);
 int place_trainer_type(Tile *tile, int num_trainer, enum character_type trainer_type, char character);
 int dijkstra(Tile *tile, enum character_type trainer_type);
-int legal_overwrite(Point point);
+int update_distances(Tile *tile, enum character_type trainer_type, int from_x, int from_y);
+int distance_field(Tile *tile, enum character_type trainer_type, int distances[TILE_LENGTH_Y][TILE_WIDTH_X], int x,
+                   int y);
+int update_distance_field(Tile *tile, enum character_type trainer_type, int distances[TILE_LENGTH_Y][TILE_WIDTH_X],
+                          int from_x, int from_y, int x, int y);
+int relax_distances(Tile *tile, enum character_type trainer_type, int distances[TILE_LENGTH_Y][TILE_WIDTH_X], int x,
+                    int y);
+int legal_overwrite(int terrain);
 double distance(int x1, int y1, int x2, int y2);
 int print_tile_terrain(Tile *tile);
 int print_tile_trainer_distances(Tile *tile);
-int print_tile_trainer_distances_printer(Tile *tile);
+int print_tile_trainer_distances_printer(int distances[TILE_LENGTH_Y][TILE_WIDTH_X]);
+int schedule_tile_characters(Tile *tile);
+size_t tile_memory(Tile *tile);
+int write_tile_record(Tile *tile, std::string &record);
+Tile *read_tile_record(const char *record, size_t size);
+Tile *fresh_tile(int x, int y);
+int pregenerate_region(int argc, char *argv[]);
+int delete_tile(Tile *tile);
+
+/*
+ * Generated tiles by world coordinates. Loaded tiles use up to budget bytes, past which the least recently used are
+ * written to a scratch file in a compact form, trainers included, and read back when they are visited again. Tiles the
+ * PC has never been on are dropped instead since create_tile makes them again exactly the same.
+ */
+class WorldStore {
+public:
+    struct Entry {
+        //NULL while the tile is evicted
+        Tile *tile;
+        size_t memory;
+        //where the tile was last written in the scratch file, -1 if it never was
+        long offset;
+        //0 when there is no record and create_tile makes the tile again
+        uint32_t size;
+        uint32_t capacity;
+        std::list<uint32_t>::iterator used;
+    };
+
+    std::unordered_map<uint32_t, Entry> entries;
+    //keys of loaded tiles, most recently used first
+    std::list<uint32_t> used;
+    size_t budget;
+    size_t memory;
+    FILE *evicted;
+    long evictedSize;
+    int evictions;
+    int reloads;
+
+    WorldStore() : budget((size_t) WORLD_MEMORY_BUDGET * 1024), memory(0), evicted(NULL), evictedSize(0),
+                   evictions(0), reloads(0) {}
+
+    static uint32_t key(int x, int y) {
+        return (uint32_t) y * WORLD_WIDTH_X + (uint32_t) x;
+    }
+
+    bool contains(int x, int y) const {
+        return entries.find(key(x, y)) != entries.end();
+    }
+
+    /*
+     * @return the tile at x, y, read back from the scratch file if it was evicted, or NULL if it was never visited
+     */
+    Tile *get(int x, int y) {
+
+        auto found = entries.find(key(x, y));
+        if (found == entries.end()) {
+            return NULL;
+        }
+        Entry &entry = found->second;
+        if (entry.tile == NULL) {
+            std::string record(entry.size, '\0');
+            if (entry.size > 0 && fseek(evicted, entry.offset, SEEK_SET) == 0
+                && fread(&record[0], 1, entry.size, evicted) == entry.size) {
+                entry.tile = read_tile_record(record.data(), record.size());
+            }
+            if (entry.tile == NULL) {
+                //tiles are generated the same way every time, so one never visited (or unreadable) is made again
+                entry.tile = fresh_tile(x, y);
+            }
+            entry.memory = tile_memory(entry.tile);
+            memory += entry.memory;
+            used.push_front(found->first);
+            entry.used = used.begin();
+            reloads++;
+        }
+        else {
+            used.splice(used.begin(), used, entry.used);
+        }
+        return entry.tile;
+
+    }
+
+    void put(int x, int y, Tile *tile) {
+
+        Entry &entry = entries[key(x, y)];
+        entry.tile = tile;
+        entry.memory = tile_memory(tile);
+        entry.offset = -1;
+        entry.size = 0;
+        entry.capacity = 0;
+        memory += entry.memory;
+        used.push_front(key(x, y));
+        entry.used = used.begin();
+
+    }
+
+    /*
+     * Evicts least recently used tiles until the loaded ones fit in budget, never the one at pinned_x, pinned_y.
+     */
+    void trim(int pinned_x, int pinned_y) {
+
+        while (memory > budget && used.size() > 1) {
+            if (used.back() == key(pinned_x, pinned_y)) {
+                //the pinned tile is in use however long ago it was looked up
+                used.splice(used.begin(), used, std::prev(used.end()));
+            }
+            if (evict(used.back()) != 0) {
+                return;
+            }
+        }
+
+    }
+
+    /*
+     * @return 0 if evicted, 1 if the tile could not be written and stays loaded
+     */
+    int evict(uint32_t tileKey) {
+
+        Entry &entry = entries[tileKey];
+        if (!entry.tile->visited) {
+            entry.size = 0;
+        }
+        else if (write_evicted(entry) != 0) {
+            return 1;
+        }
+        delete_tile(entry.tile);
+        entry.tile = NULL;
+        memory -= entry.memory;
+        used.erase(entry.used);
+        evictions++;
+        return 0;
+
+    }
+
+    int write_evicted(Entry &entry) {
+
+        std::string record;
+        write_tile_record(entry.tile, record);
+        if (evicted == NULL && (evicted = tmpfile()) == NULL) {
+            return 1;
+        }
+        //rewrite in place when the tile still fits where it was last written
+        long offset = entry.offset != -1 && record.size() <= entry.capacity ? entry.offset : evictedSize;
+        if (fseek(evicted, offset, SEEK_SET) != 0 || fwrite(record.data(), 1, record.size(), evicted) != record.size()) {
+            return 1;
+        }
+        if (offset == evictedSize) {
+            evictedSize += record.size();
+            entry.capacity = record.size();
+        }
+        entry.offset = offset;
+        entry.size = record.size();
+        return 0;
+
+    }
+};
+
+struct RegionFileHeader {
+    char magic[4];
+    uint32_t version;
+    //world the tiles were generated for, which a game using the region file plays in
+    uint64_t world_seed;
+    int32_t num_trainers;
+    int32_t growth_mode;
+    //inclusive corners of the region
+    int32_t x0;
+    int32_t y0;
+    int32_t x1;
+    int32_t y1;
+    //followed by a RegionTileEntry per tile in row order, then the tile records
+};
+
+struct RegionTileEntry {
+    uint64_t offset;
+    uint64_t size;
+};
+
+/*
+ * Tiles generated ahead of time by pregenerate, mapped so change_tile can page them in instead of generating them.
+ */
+class RegionFile {
+public:
+    const char *image;
+    size_t imageSize;
+    RegionFileHeader header;
+    const RegionTileEntry *entries;
+
+    RegionFile() : image(NULL), imageSize(0), entries(NULL) {
+        memset(&header, 0, sizeof(header));
+    }
+
+    bool contains(int x, int y) const {
+        return image != NULL && x >= header.x0 && x <= header.x1 && y >= header.y0 && y <= header.y1;
+    }
+
+    /*
+     * @return the tile at x, y as generated, or NULL if the region file does not have it
+     */
+    Tile *read(int x, int y) const {
+
+        if (!contains(x, y)) {
+            return NULL;
+        }
+        const RegionTileEntry &entry = entries[(y - header.y0) * (header.x1 - header.x0 + 1) + (x - header.x0)];
+        Tile *tile = read_tile_record(image + entry.offset, entry.size);
+        if (tile != NULL) {
+            tile->visited = false;
+        }
+        return tile;
+
+    }
+
+    /*
+     * Maps a region file written by pregenerate.
+     * @return 0 if loaded, 1 if the file could not be opened, 2 if it is not a valid region file
+     */
+    int load(const char *fileName) {
+
+        int fd = open(fileName, O_RDONLY);
+        if (fd < 0) {
+            return 1;
+        }
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 || (size_t) fileStat.st_size < sizeof(RegionFileHeader)) {
+            close(fd);
+            return 2;
+        }
+        size_t size = fileStat.st_size;
+        void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            return 2;
+        }
+        RegionFileHeader candidate;
+        memcpy(&candidate, mapping, sizeof(candidate));
+        bool valid = memcmp(candidate.magic, REGION_FILE_MAGIC, sizeof(candidate.magic)) == 0
+                && candidate.version == REGION_FILE_VERSION && candidate.x0 >= 0 && candidate.x0 <= candidate.x1
+                && candidate.x1 < WORLD_WIDTH_X && candidate.y0 >= 0 && candidate.y0 <= candidate.y1
+                && candidate.y1 < WORLD_LENGTH_Y && candidate.num_trainers >= 0
+                && candidate.num_trainers <= MAX_NUM_TRAINERS
+                && (candidate.growth_mode == GROWTH_NEIGHBOR_SCAN || candidate.growth_mode == GROWTH_FIRST_REACHED);
+        size_t tiles = valid ? (size_t) (candidate.x1 - candidate.x0 + 1) * (candidate.y1 - candidate.y0 + 1) : 0;
+        valid = valid && sizeof(RegionFileHeader) + tiles * sizeof(RegionTileEntry) <= size;
+        const RegionTileEntry *candidateEntries = (const RegionTileEntry *) ((const char *) mapping
+                                                                            + sizeof(RegionFileHeader));
+        for (size_t i = 0; valid && i < tiles; i++) {
+            valid = candidateEntries[i].offset <= size && candidateEntries[i].size <= size - candidateEntries[i].offset;
+        }
+        if (!valid) {
+            munmap(mapping, size);
+            return 2;
+        }
+        image = (const char *) mapping;
+        imageSize = size;
+        header = candidate;
+        entries = candidateEntries;
+        return 0;
+
+    }
+};
+
+/*
+ * Generates the tiles around the PC on a worker thread while the game goes on, so moving onto one of them only needs
+ * the finished tile handed over to the world store. Tile generation only draws from its own random stream and reads
+ * the pokedex, so it is safe to run next to the game.
+ */
+class TilePrefetcher {
+public:
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finishedOne;
+    //tiles waiting to be generated, nearest first
+    std::vector<std::pair<int, int>> queued;
+    //tile being generated, x -1 if none
+    std::pair<int, int> generating;
+    std::vector<Tile *> finished;
+    bool stopping;
+
+    TilePrefetcher() : generating(-1, -1), stopping(false) {}
+
+    ~TilePrefetcher() {
+        stop();
+    }
+
+    void stop() {
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        if (worker.joinable()) {
+            worker.join();
+        }
+        for (Tile *tile : finished) {
+            delete_tile(tile);
+        }
+        finished.clear();
+
+    }
+
+    /*
+     * Queues the neighbors of x, y that have not been generated yet and are not in region, replacing whatever was
+     * still queued.
+     */
+    void request(int x, int y, const WorldStore &world, const RegionFile &region) {
+
+        static const int neighbors[8][2] = {{0, -1}, {0, 1}, {1, 0}, {-1, 0}, {-1, -1}, {1, -1}, {-1, 1}, {1, 1}};
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queued.clear();
+            for (int i = 0; i < 8; i++) {
+                int neighbor_x = x + neighbors[i][0];
+                int neighbor_y = y + neighbors[i][1];
+                if (neighbor_x >= 0 && neighbor_x < WORLD_WIDTH_X && neighbor_y >= 0 && neighbor_y < WORLD_LENGTH_Y
+                    && !world.contains(neighbor_x, neighbor_y) && !region.contains(neighbor_x, neighbor_y)
+                    && generating != std::make_pair(neighbor_x, neighbor_y)
+                    && !is_finished(neighbor_x, neighbor_y)) {
+                    queued.push_back(std::make_pair(neighbor_x, neighbor_y));
+                }
+            }
+            if (!worker.joinable() && !stopping) {
+                worker = std::thread(&TilePrefetcher::run, this);
+            }
+        }
+        wake.notify_one();
+
+    }
+
+    /*
+     * Hands every finished tile over to world.
+     */
+    void publish(WorldStore &world) {
+
+        std::vector<Tile *> tiles;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tiles.swap(finished);
+        }
+        for (Tile *tile : tiles) {
+            if (world.contains(tile->x, tile->y)) {
+                delete_tile(tile);
+            }
+            else {
+                world.put(tile->x, tile->y, tile);
+            }
+        }
+
+    }
+
+    /*
+     * @return the tile at x, y once the worker has finished it if it is generating it right now, otherwise NULL after
+     * making sure the worker will not start on it
+     */
+    Tile *take(int x, int y) {
+
+        std::unique_lock<std::mutex> lock(mutex);
+        queued.erase(std::remove(queued.begin(), queued.end(), std::make_pair(x, y)), queued.end());
+        finishedOne.wait(lock, [this, x, y]() { return generating != std::make_pair(x, y); });
+        for (size_t i = 0; i < finished.size(); i++) {
+            if (finished[i]->x == x && finished[i]->y == y) {
+                Tile *tile = finished[i];
+                finished.erase(finished.begin() + i);
+                return tile;
+            }
+        }
+        return NULL;
+
+    }
+
+    bool is_finished(int x, int y) const {
+
+        for (Tile *tile : finished) {
+            if (tile->x == x && tile->y == y) {
+                return true;
+            }
+        }
+        return false;
+
+    }
+
+    void run() {
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this]() { return stopping || !queued.empty(); });
+            if (stopping) {
+                return;
+            }
+            std::pair<int, int> next = queued.front();
+            generating = next;
+            queued.erase(queued.begin());
+            lock.unlock();
+            Tile *tile = new Tile(create_tile(next.first, next.second));
+            lock.lock();
+            finished.push_back(tile);
+            generating = std::make_pair(-1, -1);
+            finishedOne.notify_all();
+        }
+
+    }
+};
 
 class UserInterface {
 public:
@@ -1001,21 +2359,27 @@ public:
 //todo: ASSIGNED: set file path to "" pre submission
 std::string filePath = "/Users/maximpopov/CLionProjects/Pokemon_C_and_CPP/";
 UserInterface *interface;
-std::vector<PokemonInfo *> allPokemonInfo;
-std::vector<Move *> allMoves;
-std::vector<PokemonMove *> allPokemonMoves;
-std::vector<PokemonSpecies *> allPokemonSpecies;
-std::vector<Experience *> allExperience;
-std::vector<TypeName *> allTypeNames;
-std::vector<PokemonStat *> allPokemonStats;
-std::vector<PokemonType *> allPokemonTypes;
-Tile *world[WORLD_LENGTH_Y][WORLD_WIDTH_X] = {0};
+PokemonTable allPokemonInfo;
+MoveTable allMoves;
+PokemonMoveTable allPokemonMoves;
+PokemonSpeciesTable allPokemonSpecies;
+ExperienceTable allExperience;
+TypeNameTable allTypeNames;
+PokemonStatTable allPokemonStats;
+PokemonTypeTable allPokemonTypes;
+TypeEfficacyTable allTypeEfficacies;
+//csv file of each pokedex table, in the order the tables are loaded and stored in a pokedex snapshot
+const char *pokedexTableFiles[POKEDEX_TABLES] = {"pokemon.csv", "moves.csv", "pokemon_moves.csv", "pokemon_species.csv",
+    "experience.csv", "type_names.csv", "pokemon_stats.csv", "pokemon_types.csv", "type_efficacy.csv"};
+TypeEfficacy typeEfficacy;
+WorldStore world;
+RegionFile region;
+TilePrefetcher prefetcher;
 int current_tile_x;
 int current_tile_y;
 Character *player_character;
 int num_trainers;
 bool cheating;
-struct heap turn_heap;
 
 int main(int argc, char *argv[]) {
 
@@ -1039,68 +2403,99 @@ int main(int argc, char *argv[]) {
 //        }
 //    }
 
-    //save database information into classes
-    if (storePokemon() != 0) {
-        std::cout << "File not opened successfully. File: pokemon.csv" << "\n";
+    if (argc >= 2 && std::string(argv[1]) == "benchmark") {
+        if (argc < 3) {
+            std::cout << "No benchmark provided." << "\n";
+            return 2;
+        }
+        return runBenchmark(argv[2]);
     }
-    if (storeMoves() != 0) {
-        std::cout << "File not opened successfully. File: moves.csv" << "\n";
+
+    //dump a single table straight from its csv file without loading the others
+    if (argc >= 2 && pokedexTableIndex(argv[1]) != -1) {
+        return dumpPokedexTable(pokedexTableIndex(argv[1]), argc, argv);
     }
-    if (storePokemonMoves() != 0) {
-        std::cout << "File not opened successfully. File: pokemon_moves.csv" << "\n";
+
+    //save database information into classes, mapped from the pokedex snapshot when there is an up to date one
+    bool compilingPokedex = argc >= 2 && std::string(argv[1]) == "compile_pokedex";
+    int snapshotResult = 1;
+    if (!compilingPokedex) {
+        snapshotResult = loadPokedexSnapshot();
     }
-    if (storePokemonSpecies() != 0) {
-        std::cout << "File not opened successfully. File: pokemon_species.csv" << "\n";
+    if (snapshotResult == 2) {
+        std::cout << "Pokedex snapshot is corrupt or out of date, reading csv files instead. Run with compile_pokedex "
+                     "to rebuild it." << "\n";
     }
-    if (storeExperience() != 0) {
-        std::cout << "File not opened successfully. File: experience.csv" << "\n";
+    if (snapshotResult != 0) {
+        int results[POKEDEX_TABLES];
+        storePokedexTables(results);
+        for (int i = 0; i < POKEDEX_TABLES; i++) {
+            if (results[i] != 0) {
+                std::cout << "File not opened successfully. File: " << pokedexTableFiles[i] << "\n";
+            }
+        }
     }
-    if (storeTypeNames() != 0) {
-        std::cout << "File not opened successfully. File: type_names.csv" << "\n";
+    if (compilingPokedex) {
+        if (compilePokedexSnapshot() != 0) {
+            std::cout << "Pokedex snapshot not written successfully. File: " << POKEDEX_SNAPSHOT_PATH << "\n";
+            return 1;
+        }
+        std::cout << "Pokedex snapshot written. File: " << POKEDEX_SNAPSHOT_PATH << "\n";
+        return 0;
     }
-    if (storePokemonStats() != 0) {
-        std::cout << "File not opened successfully. File: pokemon_stats.csv" << "\n";
+    indexMoves();
+    indexPokemon();
+    indexTypeEfficacy();
+    if (argc >= 2 && std::string(argv[1]) == "pregenerate") {
+        num_trainers = numtrainers;
+        return pregenerate_region(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "simulate") {
+        return estimateBattles(argc, argv);
+    }
+    //options of the game itself
+    world_seed = time(NULL);
+    int argument = 1;
+    while (argument < argc) {
+        std::string option = argv[argument];
+        if (option == "--world-memory" && argument + 1 < argc && atol(argv[argument + 1]) > 0) {
+            world.budget = (size_t) atol(argv[argument + 1]) * 1024;
+            argument += 2;
+        }
+        else if (option == "--growth" && argument + 1 < argc
+                 && (std::string(argv[argument + 1]) == "neighbor-scan"
+                     || std::string(argv[argument + 1]) == "first-reached")) {
+            growth_mode = std::string(argv[argument + 1]) == "neighbor-scan" ? GROWTH_NEIGHBOR_SCAN
+                                                                            : GROWTH_FIRST_REACHED;
+            argument += 2;
+        }
+        else if (option == "--region" && argument + 1 < argc) {
+            if (region.load(argv[argument + 1]) != 0) {
+                std::cout << "Region file not opened successfully. File: " << argv[argument + 1] << "\n";
+                return 1;
+            }
+            argument += 2;
+        }
+        else if (option == "--seed" && argument + 1 < argc) {
+            world_seed = strtoull(argv[argument + 1], NULL, 10);
+            argument += 2;
+        }
+        else {
+            break;
+        }
     }
-    if (storePokemonTypes() != 0) {
-        std::cout << "File not opened successfully. File: pokemon_types.csv" << "\n";
+    //tiles outside a region file only line up with the ones in it when generated the same way
+    if (region.image != NULL) {
+        world_seed = region.header.world_seed;
+        growth_mode = (enum growth_mode) region.header.growth_mode;
+        numtrainers = region.header.num_trainers;
     }
     if (argc < 2) {
         std::cout << "No arguments provided." << "\n";
     }
-    else {
-        std::string fileName = argv[1];
-        if (fileName == "pokemon") {
-            for (int i = 0; i < (int) allPokemonInfo.size(); i++) {
-                std::cout << allPokemonInfo[i]->toString() << "\n";
-            }
-        } else if (fileName == "moves") {
-            for (int i = 0; i < (int) allMoves.size(); i++) {
-                std::cout << allMoves[i]->toString() << "\n";
-            }
-        } else if (fileName == "pokemon_moves") {
-            for (int i = 0; i < (int) allPokemonMoves.size(); i++) {
-                std::cout << allPokemonMoves[i]->toString() << "\n";
-            }
-        } else if (fileName == "pokemon_species") {
-            for (int i = 0; i < (int) allPokemonSpecies.size(); i++) {
-                std::cout << allPokemonSpecies[i]->toString() << "\n";
-            }
-        } else if (fileName == "experience") {
-            for (int i = 0; i < (int) allExperience.size(); i++) {
-                std::cout << allExperience[i]->toString() << "\n";
-            }
-        } else if (fileName == "type_names") {
-            for (int i = 0; i < (int) allTypeNames.size(); i++) {
-                std::cout << allTypeNames[i]->toString() << "\n";
-            }
-        } else if (fileName == "pokemon_stats") {
-            for (int i = 0; i < (int) allPokemonStats.size(); i++) {
-                std::cout << allPokemonStats[i]->toString() << "\n";
-            }
-        } else {
-            std::cout << "Input file name: " << fileName << " is not a valid file" << "\n";
-            return 2;
-        }
+    else if (argument < argc) {
+        std::cout << "Input file name: " << argv[1] << " is not a valid file" << "\n";
+        return 2;
     }
 
 
@@ -1114,22 +2509,23 @@ int main(int argc, char *argv[]) {
     num_trainers = numtrainers;
 
     //run program
-    srand(time(NULL));
+    //the same seed generates the same world and, given the same input, plays out the same
+    srand((unsigned int) world_seed);
     interface->initializeTerminalUI();
     story_intro();
     cheat_toggle_question();
-    heap_init(&turn_heap, comparator_character_movement, NULL);
     current_tile_x = WORLD_CENTER_X;
     current_tile_y = WORLD_CENTER_Y;
-    Tile home_tile = create_tile(WORLD_CENTER_X, WORLD_CENTER_Y);
-    world[WORLD_CENTER_Y][WORLD_CENTER_X] = &home_tile;
-    place_final_boss(world[current_tile_y][current_tile_x]);
-    place_player_character(world[current_tile_y][current_tile_x]);
+    world.put(WORLD_CENTER_X, WORLD_CENTER_Y, fresh_tile(WORLD_CENTER_X, WORLD_CENTER_Y));
+    place_final_boss(world.get(current_tile_x, current_tile_y));
+    place_player_character(world.get(current_tile_x, current_tile_y));
+    prefetcher.request(current_tile_x, current_tile_y, world, region);
     while (turn_based_movement() == -1) {
-        //-1 signals map was changed: call turn_based_movement for new map/turn heap
-        //old and new Tile and heap have been updated correctly in change Tile
-            //(removed from old heap in turn_based_movement)
+        //-1 signals map was changed: call turn_based_movement for new map/turn scheduler
+        //old and new Tile and scheduler have been updated correctly in change Tile
+            //(removed from old scheduler in turn_based_movement)
     }
+    prefetcher.stop();
     interface->endwinUI();
     return 0;
 
@@ -1143,386 +2539,923 @@ int print_usage() {
 
 }
 
-int storePokemon() {
+/*
+ * Reads a whole csv file of the pokedex into contents.
+ * @return 0 if read, 1 if the file could not be opened
+ */
+int readPokedexFile(const char *fileName, std::string &contents) {
 
-    std::ifstream file;
-    file.open(filePath + "pokedex/pokedex/data/csv/pokemon.csv");
-    if (file.is_open()) {
-        std:: string id, name, species_id, height, weight, base_experience, order, is_default;
-        getline(file, id, '\n');
-        while(getline(file, id, ',')) {
-            getline(file, name, ',');
-            getline(file, species_id, ',');
-            getline(file, height, ',');
-            getline(file, weight, ',');
-            getline(file, base_experience, ',');
-            getline(file, order, ',');
-            getline(file, is_default, '\n');
-            if (id == "") {
-                id = "-1";
-            }
-            if (name == "") {
-                name = "-1";
-            }
-            if (species_id == "") {
-                species_id = "-1";
-            }
-            if (height == "") {
-                height = "-1";
-            }
-            if (weight == "") {
-                weight = "-1";
-            }
-            if (base_experience == "") {
-                base_experience = "-1";
-            }
-            if (order == "") {
-                order = "-1";
+    std::ifstream file(filePath + "pokedex/pokedex/data/csv/" + fileName, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return 1;
+    }
+    contents.resize(file.tellg());
+    file.seekg(0);
+    file.read(&contents[0], contents.size());
+    contents.resize(file.gcount());
+
+    return 0;
+
+}
+
+/*
+ * Walks csv text field by field without copying it. Fields are views into the text, valid as long as it is.
+ */
+class CsvCursor {
+public:
+    CsvCursor(const char *begin, const char *end) : position(begin), end(end) {}
+
+    bool atEnd() const {
+        return position >= end;
+    }
+
+    //the next field of the current line, empty once the line has no more fields
+    std::string_view nextField() {
+        const char *fieldBegin = position;
+        while (position < end && *position != ',' && *position != '\n') {
+            position++;
+        }
+        std::string_view field(fieldBegin, position - fieldBegin);
+        if (position < end && *position == ',') {
+            position++;
+        }
+        if (!field.empty() && field.back() == '\r') {
+            field.remove_suffix(1);
+        }
+        return field;
+    }
+
+    //parses the next field as a number in place
+    //@return false if the field is empty or not a number
+    bool nextInt(int &value) {
+        std::from_chars_result result = std::from_chars(position, end, value);
+        if (result.ec == std::errc()) {
+            position = result.ptr;
+        }
+        return nextField().empty() && result.ec == std::errc();
+    }
+
+    //skips whatever is left of the current line
+    void nextLine() {
+        while (position < end && *position != '\n') {
+            position++;
+        }
+        if (position < end) {
+            position++;
+        }
+    }
+
+private:
+    const char *position;
+    const char *end;
+};
+
+static void storeField(Column<int> &column, CsvCursor &cursor) {
+    int value;
+    if (!cursor.nextInt(value)) {
+        value = POKEDEX_NULL;
+    }
+    column.push_back(value);
+}
+
+static void storeField(Column<uint32_t> &column, CsvCursor &cursor) {
+    std::string_view field = cursor.nextField();
+    column.push_back(field.empty() ? POKEDEX_NULL_STRING : pokedexStrings.add(field));
+}
+
+/*
+ * Appends the csv rows between begin and end (no header) to a table, one field per column in forEachColumn order.
+ * Missing fields are null and extra fields are ignored.
+ */
+template <typename Table>
+int storeTable(Table &table, const char *begin, const char *end) {
+
+    uint32_t rows = std::count(begin, end, '\n') + 1;
+    table.forEachColumn([rows](auto &column) { column.reserve(rows); });
+    CsvCursor cursor(begin, end);
+    while (!cursor.atEnd()) {
+        table.forEachColumn([&cursor](auto &column) { storeField(column, cursor); });
+        cursor.nextLine();
+    }
+
+    return 0;
+
+}
+
+/*
+ * Loading of one pokedex table from csv, in three steps so that the steps of all tables can run in parallel: reading
+ * the file, parsing each chunk of it into a table of its own, then appending the chunks to the table in file order.
+ */
+class PokedexTableLoad {
+public:
+    virtual ~PokedexTableLoad() {}
+    //@return 0 if read, 1 if the file could not be opened
+    virtual int read() = 0;
+    virtual int chunkCount() = 0;
+    virtual void parse(int chunk) = 0;
+    virtual void merge() = 0;
+};
+
+template <typename Table>
+class CsvTableLoad : public PokedexTableLoad {
+public:
+    CsvTableLoad(Table &table, const char *fileName) : table(table), fileName(fileName) {}
+
+    int read() {
+        if (readPokedexFile(fileName, contents) != 0) {
+            return 1;
+        }
+        //skip the header, then cut the rest into chunks at line ends
+        size_t begin = contents.find('\n');
+        begin = begin == std::string::npos ? contents.size() : begin + 1;
+        while (begin < contents.size()) {
+            size_t end = contents.size();
+            if (end - begin > POKEDEX_CHUNK_SIZE) {
+                end = contents.find('\n', begin + POKEDEX_CHUNK_SIZE);
+                end = end == std::string::npos ? contents.size() : end + 1;
             }
-            if (is_default == "") {
-                is_default = "-1";
+            chunkRanges.push_back(std::make_pair(begin, end));
+            begin = end;
+        }
+        //the first chunk is parsed straight into the table
+        for (int i = 1; i < (int) chunkRanges.size(); i++) {
+            chunks.push_back(std::unique_ptr<Table>(new Table()));
+        }
+        return 0;
+    }
+
+    int chunkCount() {
+        return chunkRanges.size();
+    }
+
+    void parse(int chunk) {
+        storeTable(chunk == 0 ? table : *chunks[chunk - 1], contents.data() + chunkRanges[chunk].first,
+                   contents.data() + chunkRanges[chunk].second);
+    }
+
+    void merge() {
+        for (int i = 0; i < (int) chunks.size(); i++) {
+            std::vector<const void *> columns;
+            chunks[i]->forEachColumn([&columns](auto &column) { columns.push_back(&column); });
+            int column = 0;
+            table.forEachColumn([&columns, &column](auto &tableColumn) {
+                tableColumn.append(*(const std::remove_reference_t<decltype(tableColumn)> *) columns[column++]);
+            });
+        }
+        chunks.clear();
+        contents.clear();
+    }
+
+private:
+    Table &table;
+    const char *fileName;
+    std::string contents;
+    std::vector<std::pair<size_t, size_t>> chunkRanges;
+    std::vector<std::unique_ptr<Table>> chunks;
+};
+
+/*
+ * Runs every task exactly once on up to one thread per core.
+ */
+void runInParallel(const std::vector<std::function<void()>> &tasks) {
+
+    std::atomic<size_t> next(0);
+    size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, tasks.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadCount; i++) {
+        threads.push_back(std::thread([&tasks, &next]() {
+            for (size_t task = next++; task < tasks.size(); task = next++) {
+                tasks[task]();
             }
-            PokemonInfo *pokemon = new PokemonInfo(id, name, species_id, height, weight, base_experience, order, is_default);
-            allPokemonInfo.push_back(pokemon);
+        }));
+    }
+    for (int i = 0; i < (int) threads.size(); i++) {
+        threads[i].join();
+    }
+
+}
+
+/*
+ * Reads every pokedex table from its csv file, all tables and all chunks of large tables in parallel.
+ * @param results set per table in pokedexTableFiles order: 0 if read, 1 if the file could not be opened
+ */
+int storePokedexTables(int results[POKEDEX_TABLES]) {
+
+    std::unique_ptr<PokedexTableLoad> loads[POKEDEX_TABLES] = {
+            std::unique_ptr<PokedexTableLoad>(new CsvTableLoad<PokemonTable>(allPokemonInfo, pokedexTableFiles[0])),
+            std::unique_ptr<PokedexTableLoad>(new CsvTableLoad<MoveTable>(allMoves, pokedexTableFiles[1])),
+            std::unique_ptr<PokedexTableLoad>(new CsvTableLoad<PokemonMoveTable>(allPokemonMoves, pokedexTableFiles[2])),
+            std::unique_ptr<PokedexTableLoad>(new CsvTableLoad<PokemonSpeciesTable>(allPokemonSpecies,
+                                                                                    pokedexTableFiles[3])),
+            std::unique_ptr<PokedexTableLoad>(new CsvTableLoad<ExperienceTable>(allExperience, pokedexTableFiles[4])),
+            std::unique_ptr<PokedexTableLoad>(new CsvTableLoad<TypeNameTable>(allTypeNames, pokedexTableFiles[5])),
+            std::unique_ptr<PokedexTableLoad>(new CsvTableLoad<PokemonStatTable>(allPokemonStats, pokedexTableFiles[6])),
+            std::unique_ptr<PokedexTableLoad>(new CsvTableLoad<PokemonTypeTable>(allPokemonTypes,
+                                                                                 pokedexTableFiles[7])),
+            std::unique_ptr<PokedexTableLoad>(new CsvTableLoad<TypeEfficacyTable>(allTypeEfficacies,
+                                                                                  pokedexTableFiles[8]))};
+
+    std::vector<std::function<void()>> tasks;
+    for (int i = 0; i < POKEDEX_TABLES; i++) {
+        tasks.push_back([&loads, results, i]() { results[i] = loads[i]->read(); });
+    }
+    runInParallel(tasks);
+
+    tasks.clear();
+    for (int i = 0; i < POKEDEX_TABLES; i++) {
+        for (int chunk = 0; chunk < loads[i]->chunkCount(); chunk++) {
+            tasks.push_back([&loads, i, chunk]() { loads[i]->parse(chunk); });
         }
     }
+    runInParallel(tasks);
+
+    tasks.clear();
+    for (int i = 0; i < POKEDEX_TABLES; i++) {
+        tasks.push_back([&loads, i]() { loads[i]->merge(); });
+    }
+    runInParallel(tasks);
+
+    return 0;
+
+}
+
+//the getline, "-1" and stoi pipeline csv was read with before storeTable, kept as the baseline of benchmark csv
+static void legacyStoreField(Column<int> &column, std::string field) {
+    if (field == "") {
+        field = "-1";
+    }
+    column.push_back(stoi(field));
+}
+
+static void legacyStoreField(Column<uint32_t> &column, std::string field) {
+    if (field == "") {
+        field = "-1";
+    }
+    column.push_back(pokedexStrings.add(field));
+}
+
+template <typename Table>
+void legacyStoreTable(Table &table, std::istream &file) {
+
+    int fieldCount = 0;
+    table.forEachColumn([&fieldCount](auto &) { fieldCount++; });
+    std::string field;
+    while (file.peek() != EOF) {
+        int fieldIndex = 0;
+        table.forEachColumn([&file, &field, &fieldIndex, fieldCount](auto &column) {
+            getline(file, field, ++fieldIndex == fieldCount ? '\n' : ',');
+            legacyStoreField(column, field);
+        });
+    }
+
+}
+
+/*
+ * Times parsing one csv file with the legacy pipeline and with storeTable and prints both throughputs.
+ */
+template <typename Table>
+void benchmarkCsvTable(const char *fileName, int repetitions) {
+
+    std::string contents;
+    if (readPokedexFile(fileName, contents) != 0) {
+        std::cout << "File not opened successfully. File: " << fileName << "\n";
+        return;
+    }
+    size_t header = contents.find('\n') + 1;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; i++) {
+        Table table;
+        std::istringstream stream(contents.substr(header));
+        legacyStoreTable(table, stream);
+    }
+    double legacySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; i++) {
+        Table table;
+        storeTable(table, contents.data() + header, contents.data() + contents.size());
+    }
+    double tokenizerSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double megabytes = (double) contents.size() * repetitions / (1024 * 1024);
+    std::cout << fileName << ": getline/stoi " << megabytes / legacySeconds << " MB/s, tokenizer "
+              << megabytes / tokenizerSeconds << " MB/s, " << legacySeconds / tokenizerSeconds << "x" << "\n";
+
+}
+
+/*
+ * Runs the benchmark with the given name and prints its results.
+ * @return 0 if run, 2 if there is no such benchmark
+ */
+int runBenchmark(const std::string &name) {
+
+    if (name == "csv") {
+        int repetitions = 200;
+        benchmarkCsvTable<PokemonTable>(pokedexTableFiles[0], repetitions);
+        benchmarkCsvTable<MoveTable>(pokedexTableFiles[1], repetitions);
+        benchmarkCsvTable<PokemonMoveTable>(pokedexTableFiles[2], repetitions);
+        benchmarkCsvTable<PokemonSpeciesTable>(pokedexTableFiles[3], repetitions);
+        benchmarkCsvTable<ExperienceTable>(pokedexTableFiles[4], repetitions);
+        benchmarkCsvTable<TypeNameTable>(pokedexTableFiles[5], repetitions);
+        benchmarkCsvTable<PokemonStatTable>(pokedexTableFiles[6], repetitions);
+        benchmarkCsvTable<PokemonTypeTable>(pokedexTableFiles[7], repetitions);
+        benchmarkCsvTable<TypeEfficacyTable>(pokedexTableFiles[8], repetitions);
+    }
+    else if (name == "grow") {
+        return benchmark_grow_seeds(2000);
+    }
+    else if (name == "turns") {
+        return benchmark_turns(5000, 2000000);
+    }
+    else if (name == "heap") {
+        return benchmark_heap(100000, 20);
+    }
+    else if (name == "queues") {
+        return benchmark_queues(100, 5000, 2000000);
+    }
+    else if (name == "walkers") {
+        return benchmark_walkers(200, 20000);
+    }
+    else if (name == "distances") {
+        return benchmark_distances(100, 1000);
+    }
+    else if (name == "pacing") {
+        return benchmark_distance_cache(100, 1000);
+    }
     else {
-        //file not opened successfully
-        return 1;
+        std::cout << "Benchmark: " << name << " does not exist. Benchmarks: csv, grow, turns, heap, queues, "
+                  << "walkers, distances, pacing" << "\n";
+        return 2;
     }
 
     return 0;
 
 }
 
-int storeMoves() {
+/*
+ * Output collected into large blocks before it is written, instead of a stream flush per line.
+ */
+class OutputBuffer {
+public:
+    OutputBuffer(FILE *file) : file(file) {
+        buffer.reserve(DUMP_BUFFER_SIZE + 4096);
+    }
+
+    ~OutputBuffer() {
+        flush();
+    }
 
-    std::ifstream file;
-    file.open(filePath + "pokedex/pokedex/data/csv/moves.csv");
-    if (file.is_open()) {
-        std:: string id, name, generation_id, type_id, power, pp, accuracy, priority, target_id, damage_class_id, effect_id,
-                effect_chance, contest_type_id, contest_effect_id, super_contest_effect_id;
-        getline(file, id, '\n');
-        while(getline(file, id, ',')) {
-            getline(file, name, ',');
-            getline(file, generation_id, ',');
-            getline(file, type_id, ',');
-            getline(file, power, ',');
-            getline(file, pp, ',');
-            getline(file, accuracy, ',');
-            getline(file, priority, ',');
-            getline(file, target_id, ',');
-            getline(file, damage_class_id, ',');
-            getline(file, effect_id, ',');
-            getline(file, effect_chance, ',');
-            getline(file, contest_type_id, ',');
-            getline(file, contest_effect_id, ',');
-            getline(file, super_contest_effect_id, '\n');
-            if (id == "") {
-                id = "-1";
-            }
-            if (name == "") {
-                name = "-1";
-            }
-            if (generation_id == "") {
-                generation_id = "-1";
-            }
-            if (type_id == "") {
-                type_id = "-1";
+    void append(std::string_view text) {
+        buffer.append(text.data(), text.size());
+        if (buffer.size() >= DUMP_BUFFER_SIZE) {
+            flush();
+        }
+    }
+
+    void append(char c) {
+        buffer.push_back(c);
+    }
+
+    void appendInt(int value) {
+        char digits[16];
+        append(std::string_view(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr - digits));
+    }
+
+    //appends text as a json string, quoted and escaped
+    void appendJsonString(std::string_view text) {
+        append('"');
+        for (size_t i = 0; i < text.size(); i++) {
+            unsigned char c = text[i];
+            if (c == '"' || c == '\\') {
+                append('\\');
+                append((char) c);
             }
-            if (power == "") {
-                power = "-1";
+            else if (c < 0x20) {
+                char escape[8];
+                snprintf(escape, sizeof(escape), "\\u%04x", c);
+                append(escape);
             }
-            if (pp == "") {
-                pp = "-1";
+            else {
+                append((char) c);
             }
-            if (accuracy == "") {
-                accuracy = "-1";
+        }
+        append('"');
+    }
+
+    void flush() {
+        fwrite(buffer.data(), 1, buffer.size(), file);
+        fflush(file);
+        buffer.clear();
+    }
+
+private:
+    FILE *file;
+    std::string buffer;
+};
+
+/*
+ * A --field=value argument of a table dump: only rows whose field equals the value are written.
+ */
+struct DumpFilter {
+    int field;
+    bool null;
+    int value;
+    std::string text;
+};
+
+//whether each column of a table holds text, in csv order
+struct ColumnKinds {
+    std::vector<bool> &text;
+
+    void operator()(Column<int> &) {
+        text.push_back(false);
+    }
+
+    void operator()(Column<uint32_t> &) {
+        text.push_back(true);
+    }
+};
+
+/*
+ * @return position of the table in pokedexTableFiles, with or without .csv, -1 if there is no such table
+ */
+int pokedexTableIndex(const std::string &name) {
+
+    for (int i = 0; i < POKEDEX_TABLES; i++) {
+        if (name == pokedexTableFiles[i] || name + ".csv" == pokedexTableFiles[i]) {
+            return i;
+        }
+    }
+
+    return -1;
+
+}
+
+/*
+ * Streams one csv file of the pokedex to stdout in normalized form without loading it into a table. The options
+ * after the table name are --format=csv|tsv|json and any number of --field=value filters, with - or _ in the field
+ * name. Null fields are written empty in csv and tsv and as null in json.
+ * @return 0 if written, 1 if the file could not be opened, 2 if an option is not valid
+ */
+template <typename Table>
+int dumpTable(const char *fileName, int argc, char *argv[]) {
+
+    std::vector<bool> text;
+    Table schema;
+    schema.forEachColumn(ColumnKinds{text});
+    int fieldCount = text.size();
+
+    std::string contents;
+    if (readPokedexFile(fileName, contents) != 0) {
+        std::cout << "File not opened successfully. File: " << fileName << "\n";
+        return 1;
+    }
+    //field names come from the csv header
+    const char *begin = contents.data();
+    const char *end = contents.data() + contents.size();
+    CsvCursor header(begin, end);
+    std::vector<std::string> names;
+    for (int i = 0; i < fieldCount; i++) {
+        std::string_view name = header.nextField();
+        names.push_back(name.empty() ? "field" + std::to_string(i + 1) : std::string(name));
+    }
+    header.nextLine();
+
+    std::string format = "csv";
+    std::vector<DumpFilter> filters;
+    for (int i = 2; i < argc; i++) {
+        std::string argument = argv[i];
+        size_t equals = argument.find('=');
+        if (argument.compare(0, 2, "--") != 0 || equals == std::string::npos) {
+            std::cout << "Dump option: " << argument << " is not valid, expected --format=csv|tsv|json or --field=value"
+                      << "\n";
+            return 2;
+        }
+        std::string option = argument.substr(2, equals - 2);
+        std::string value = argument.substr(equals + 1);
+        std::replace(option.begin(), option.end(), '-', '_');
+        if (option == "format") {
+            if (value != "csv" && value != "tsv" && value != "json") {
+                std::cout << "Dump format: " << value << " is not valid, expected csv, tsv or json" << "\n";
+                return 2;
             }
-            if (priority == "") {
-                priority = "-1";
+            format = value;
+            continue;
+        }
+        DumpFilter filter;
+        filter.field = std::find(names.begin(), names.end(), option) - names.begin();
+        if (filter.field == fieldCount) {
+            std::cout << "Dump filter: " << option << " is not a field of " << fileName << "\n";
+            return 2;
+        }
+        filter.null = value.empty();
+        filter.value = 0;
+        filter.text = value;
+        if (!text[filter.field] && !filter.null) {
+            std::from_chars_result result = std::from_chars(value.data(), value.data() + value.size(), filter.value);
+            if (result.ec != std::errc() || result.ptr != value.data() + value.size()) {
+                std::cout << "Dump filter: " << option << " needs a number, not " << value << "\n";
+                return 2;
             }
-            if (target_id == "") {
-                target_id = "-1";
+        }
+        filters.push_back(filter);
+    }
+    char separator = format == "tsv" ? '\t' : ',';
+    bool json = format == "json";
+
+    OutputBuffer output(stdout);
+    std::vector<std::string_view> fields(fieldCount);
+    std::vector<int> values(fieldCount);
+    std::vector<char> present(fieldCount);
+    CsvCursor cursor(header);
+    bool firstRow = true;
+    if (json) {
+        output.append('[');
+    }
+    while (!cursor.atEnd()) {
+        for (int i = 0; i < fieldCount; i++) {
+            if (text[i]) {
+                fields[i] = cursor.nextField();
+                present[i] = !fields[i].empty();
             }
-            if (damage_class_id == "") {
-                damage_class_id = "-1";
+            else {
+                present[i] = cursor.nextInt(values[i]);
             }
-            if (effect_id == "") {
-                effect_id = "-1";
+        }
+        cursor.nextLine();
+
+        bool matches = true;
+        for (int i = 0; matches && i < (int) filters.size(); i++) {
+            const DumpFilter &filter = filters[i];
+            if (filter.null || !present[filter.field]) {
+                matches = filter.null && !present[filter.field];
             }
-            if (effect_chance == "") {
-                effect_chance = "-1";
+            else if (text[filter.field]) {
+                matches = fields[filter.field] == filter.text;
             }
-            if (contest_type_id == "") {
-                contest_type_id = "-1";
+            else {
+                matches = values[filter.field] == filter.value;
             }
-            if (contest_effect_id == "") {
-                contest_effect_id = "-1";
+        }
+        if (!matches) {
+            continue;
+        }
+
+        if (json) {
+            output.append(firstRow ? "\n{" : ",\n{");
+            for (int i = 0; i < fieldCount; i++) {
+                if (i > 0) {
+                    output.append(',');
+                }
+                output.appendJsonString(names[i]);
+                output.append(':');
+                if (!present[i]) {
+                    output.append("null");
+                }
+                else if (text[i]) {
+                    output.appendJsonString(fields[i]);
+                }
+                else {
+                    output.appendInt(values[i]);
+                }
             }
-            if (super_contest_effect_id == "") {
-                super_contest_effect_id = "-1";
+            output.append('}');
+        }
+        else {
+            for (int i = 0; i < fieldCount; i++) {
+                if (i > 0) {
+                    output.append(separator);
+                }
+                if (!present[i]) {
+                    continue;
+                }
+                if (text[i]) {
+                    output.append(fields[i]);
+                }
+                else {
+                    output.appendInt(values[i]);
+                }
             }
-            Move *move = new Move(id, name, generation_id, type_id, power, pp, accuracy, priority, target_id, damage_class_id,
-                                  effect_id, effect_chance, contest_type_id, contest_effect_id, super_contest_effect_id);
-            allMoves.push_back(move);
+            output.append('\n');
         }
+        firstRow = false;
     }
-    else {
-        //file not opened successfully
-        return 1;
+    if (json) {
+        output.append("\n]\n");
     }
 
     return 0;
 
 }
 
-int storePokemonMoves() {
+int dumpPokedexTable(int table, int argc, char *argv[]) {
+
+    switch (table) {
+        case 0:
+            return dumpTable<PokemonTable>(pokedexTableFiles[table], argc, argv);
+        case 1:
+            return dumpTable<MoveTable>(pokedexTableFiles[table], argc, argv);
+        case 2:
+            return dumpTable<PokemonMoveTable>(pokedexTableFiles[table], argc, argv);
+        case 3:
+            return dumpTable<PokemonSpeciesTable>(pokedexTableFiles[table], argc, argv);
+        case 4:
+            return dumpTable<ExperienceTable>(pokedexTableFiles[table], argc, argv);
+        case 5:
+            return dumpTable<TypeNameTable>(pokedexTableFiles[table], argc, argv);
+        case 6:
+            return dumpTable<PokemonStatTable>(pokedexTableFiles[table], argc, argv);
+        case 7:
+            return dumpTable<PokemonTypeTable>(pokedexTableFiles[table], argc, argv);
+        case 8:
+            return dumpTable<TypeEfficacyTable>(pokedexTableFiles[table], argc, argv);
+    }
+
+    return 2;
 
-    std::ifstream file;
-    file.open(filePath + "pokedex/pokedex/data/csv/pokemon_moves.csv");
-    if (file.is_open()) {
-        std:: string pokemon_id, version_group_id, move_id, pokemon_move_method_id, level, order;
-        getline(file, pokemon_id, '\n');
-        while(getline(file, pokemon_id, ',')) {
-            getline(file, version_group_id, ',');
-            getline(file, move_id, ',');
-            getline(file, pokemon_move_method_id, ',');
-            getline(file, level, ',');
-            getline(file, order, '\n');
-            if (pokemon_id == "") {
-                pokemon_id = "-1";
-            }
-            if (version_group_id == "") {
-                version_group_id = "-1";
-            }
-            if (move_id == "") {
-                move_id = "-1";
-            }
-            if (pokemon_move_method_id == "") {
-                pokemon_move_method_id = "-1";
-            }
-            if (level == "") {
-                level = "-1";
-            }
-            if (order == "") {
-                order = "-1";
-            }
-            PokemonMove *pokemonMove = new PokemonMove(pokemon_id, version_group_id, move_id, pokemon_move_method_id, level,
-                order);
-            allPokemonMoves.push_back(pokemonMove);
+}
+
+/*
+ * Builds moveRegistry from the moves table.
+ */
+int indexMoves() {
+
+    Move sentinel;
+    sentinel.id = sentinel.generation_id = sentinel.type_id = sentinel.power = sentinel.pp = sentinel.accuracy
+            = sentinel.priority = sentinel.target_id = sentinel.damage_class_id = sentinel.effect_id
+            = sentinel.effect_chance = sentinel.contest_type_id = sentinel.contest_effect_id
+            = sentinel.super_contest_effect_id = POKEDEX_NULL;
+    sentinel.nameOffset = POKEDEX_NULL_STRING;
+    int maxMoveID = 0;
+    for (uint32_t i = 0; i < allMoves.size(); i++) {
+        if (allMoves.id[i] > maxMoveID) {
+            maxMoveID = allMoves.id[i];
         }
     }
-    else {
-        //file not opened successfully
-        return 1;
+    moveRegistry.moves.assign(maxMoveID + 1, sentinel);
+    for (uint32_t i = 0; i < allMoves.size(); i++) {
+        if (allMoves.id[i] > 0) {
+            moveRegistry.moves[allMoves.id[i]] = allMoves.row(i);
+        }
     }
 
     return 0;
 
 }
 
-int storePokemonSpecies() {
+/*
+ * Builds pokemonIndex from the pokedex tables so creating a pokemon does not have to scan them.
+ */
+int indexPokemon() {
 
-    std::ifstream file;
-    file.open(filePath + "pokedex/pokedex/data/csv/pokemon_species.csv");
-    if (file.is_open()) {
-        std:: string id, identifier, generation_id, evolves_from_species_id, evolution_chain_id, color_id, shape_id,
-            habitat_id, gender_rate, capture_rate, base_happiness, is_baby, hatch_counter, has_gender_differences,
-            growth_rate_id, forms_switchable, is_legendary, is_mythical, order, conquest_order;
-        getline(file, id, '\n');
-        while(getline(file, id, ',')) {
-            getline(file, identifier, ',');
-            getline(file, generation_id, ',');
-            getline(file, evolves_from_species_id, ',');
-            getline(file, evolution_chain_id, ',');
-            getline(file, color_id, ',');
-            getline(file, shape_id, ',');
-            getline(file, habitat_id, ',');
-            getline(file, gender_rate, ',');
-            getline(file, capture_rate, ',');
-            getline(file, base_happiness, ',');
-            getline(file, is_baby, ',');
-            getline(file, hatch_counter, ',');
-            getline(file, has_gender_differences, ',');
-            getline(file, growth_rate_id, ',');
-            getline(file, forms_switchable, ',');
-            getline(file, is_legendary, ',');
-            getline(file, is_mythical, ',');
-            getline(file, order, ',');
-            getline(file, conquest_order, '\n');
-            if (id == "") {
-                id = "-1";
-            }
-            if (identifier == "") {
-                identifier = "-1";
-            }
-            if (generation_id == "") {
-                generation_id = "-1";
-            }
-            if (generation_id == "") {
-                generation_id = "-1";
-            }
-            if (evolves_from_species_id == "") {
-                evolves_from_species_id = "-1";
-            }
-            if (evolution_chain_id == "") {
-                evolution_chain_id = "-1";
-            }
-            if (color_id == "") {
-                color_id = "-1";
-            }
-            if (shape_id == "") {
-                shape_id = "-1";
-            }
-            if (habitat_id == "") {
-                habitat_id = "-1";
-            }
-            if (gender_rate == "") {
-                gender_rate = "-1";
+    pokemonIndex.entries.clear();
+    pokemonIndex.levelUpMoves.clear();
+    pokemonIndex.entryByID.clear();
+    for (uint32_t i = 0; i < allPokemonInfo.size(); i++) {
+        PokemonIndexEntry entry = {allPokemonInfo.row(i), 0, 0, {0, 0, 0, 0, 0, 0}, {-1, -1}};
+        pokemonIndex.entries.push_back(entry);
+        int id = allPokemonInfo.id[i];
+        if (id >= 0) {
+            if (id >= (int) pokemonIndex.entryByID.size()) {
+                pokemonIndex.entryByID.resize(id + 1, -1);
             }
-            if (capture_rate == "") {
-                capture_rate = "-1";
-            }
-            if (base_happiness == "") {
-                base_happiness = "-1";
-            }
-            if (is_baby == "") {
-                is_baby = "-1";
-            }
-            if (hatch_counter == "") {
-                hatch_counter = "-1";
-            }
-            if (has_gender_differences == "") {
-                has_gender_differences = "-1";
-            }
-            if (growth_rate_id == "") {
-                growth_rate_id = "-1";
-            }
-            if (forms_switchable == "") {
-                forms_switchable = "-1";
-            }
-            if (is_legendary == "") {
-                is_legendary = "-1";
-            }
-            if (is_mythical == "") {
-                is_mythical = "-1";
-            }
-            if (order == "") {
-                order = "-1";
-            }
-            if (conquest_order == "") {
-                conquest_order = "-1";
-            }
-            PokemonSpecies *pokemonSpecies = new PokemonSpecies(id, identifier, generation_id, evolves_from_species_id,
-                evolution_chain_id, color_id, shape_id, habitat_id, gender_rate, capture_rate, base_happiness, is_baby,
-                hatch_counter, has_gender_differences, growth_rate_id, forms_switchable, is_legendary, is_mythical, order,
-                conquest_order);
-            allPokemonSpecies.push_back(pokemonSpecies);
+            pokemonIndex.entryByID[id] = i;
         }
     }
-    else {
-        //file not opened successfully
-        return 1;
+
+    for (uint32_t i = 0; i < allPokemonStats.size(); i++) {
+        PokemonIndexEntry *entry = pokemonIndex.find(allPokemonStats.pokemon_id[i]);
+        int stat_id = allPokemonStats.stat_id[i];
+        if (entry != NULL && stat_id >= 1 && stat_id <= 6) {
+            entry->baseStats[stat_id - 1] = allPokemonStats.base_stat[i];
+        }
+    }
+
+    for (uint32_t i = 0; i < allPokemonTypes.size(); i++) {
+        PokemonIndexEntry *entry = pokemonIndex.find(allPokemonTypes.pokemon_id[i]);
+        int slot = allPokemonTypes.slot[i];
+        if (entry != NULL && (slot == 1 || slot == 2)) {
+            entry->typeIDs[slot - 1] = allPokemonTypes.type_id[i];
+        }
+    }
+
+    //level up moves (method 1) grouped by pokemon and sorted by level, each move kept at the lowest level it is learned
+    std::vector<std::pair<int, LevelUpMove>> learnset;
+    for (uint32_t i = 0; i < allPokemonMoves.size(); i++) {
+        if (allPokemonMoves.pokemon_move_method_id[i] == 1 && pokemonIndex.find(allPokemonMoves.pokemon_id[i]) != NULL) {
+            LevelUpMove levelUpMove = {allPokemonMoves.move_id[i], allPokemonMoves.level[i]};
+            learnset.push_back(std::make_pair(pokemonIndex.entryByID[allPokemonMoves.pokemon_id[i]], levelUpMove));
+        }
+    }
+    std::sort(learnset.begin(), learnset.end(),
+              [](const std::pair<int, LevelUpMove> &a, const std::pair<int, LevelUpMove> &b) {
+        if (a.first != b.first) {
+            return a.first < b.first;
+        }
+        if (a.second.level != b.second.level) {
+            return a.second.level < b.second.level;
+        }
+        return a.second.move_id < b.second.move_id;
+    });
+    for (int i = 0; i < (int) learnset.size(); i++) {
+        PokemonIndexEntry &entry = pokemonIndex.entries[learnset[i].first];
+        if (entry.levelUpMoveCount == 0) {
+            entry.firstLevelUpMove = pokemonIndex.levelUpMoves.size();
+        }
+        bool known = false;
+        for (uint32_t j = entry.firstLevelUpMove; j < entry.firstLevelUpMove + entry.levelUpMoveCount; j++) {
+            if (pokemonIndex.levelUpMoves[j].move_id == learnset[i].second.move_id) {
+                known = true;
+                break;
+            }
+        }
+        if (!known) {
+            pokemonIndex.levelUpMoves.push_back(learnset[i].second);
+            entry.levelUpMoveCount++;
+        }
     }
 
     return 0;
 
 }
 
-int storeExperience() {
+/*
+ * Builds typeEfficacy from the type efficacy table. Matchups missing from the table, as all are without the csv file,
+ * stay neutral.
+ */
+int indexTypeEfficacy() {
 
-    std::ifstream file;
-    file.open(filePath + "pokedex/pokedex/data/csv/experience.csv");
-    if (file.is_open()) {
-        std::string growth_rate_id, level, experience;
-        getline(file, growth_rate_id, '\n');
-        while(getline(file, growth_rate_id, ',')) {
-            getline(file, level, ',');
-            getline(file, experience, '\n');
-            if (growth_rate_id == "") {
-                growth_rate_id = "-1";
-            }
-            if (level == "") {
-                level = "-1";
-            }
-            if (experience == "") {
-                experience = "-1";
-            }
-            Experience *experience1 = new Experience(growth_rate_id, level, experience);
-            allExperience.push_back(experience1);
+    typeEfficacy.reset();
+    for (uint32_t i = 0; i < allTypeEfficacies.size(); i++) {
+        if (allTypeEfficacies.damage_factor[i] != POKEDEX_NULL) {
+            typeEfficacy.set(allTypeEfficacies.damage_type_id[i], allTypeEfficacies.target_type_id[i],
+                             allTypeEfficacies.damage_factor[i] / 100.0f);
         }
     }
-    else {
-        //file not opened successfully
-        return 1;
-    }
+    typeEfficacy.precompute();
 
     return 0;
 
 }
 
-int storeTypeNames() {
+/*
+ * Position of a column (or the string pool) in a pokedex snapshot.
+ */
+struct PokedexSnapshotSection {
+    uint64_t offset;
+    uint64_t size;
+    uint32_t count;
+    uint32_t recordSize;
+};
+
+/*
+ * Size and modification time of a csv file a pokedex snapshot was compiled from, so a snapshot older than its csv
+ * files is not used. -1 if the file is missing.
+ */
+struct PokedexSnapshotSource {
+    int64_t size;
+    int64_t modified;
+};
 
-    std::ifstream file;
-    file.open(filePath + "pokedex/pokedex/data/csv/type_names.csv");
-    if (file.is_open()) {
-        std::string type_id, local_language_id, name;
-        getline(file, type_id, '\n');
-        while(getline(file, type_id, ',')) {
-            getline(file, local_language_id, ',');
-            getline(file, name, '\n');
-            if (type_id == "") {
-                type_id = "-1";
-            }
-            if (local_language_id == "") {
-                local_language_id = "-1";
-            }
-            if (name == "") {
-                name = "-1";
-            }
-            TypeName *typeName = new TypeName(type_id, local_language_id, name);
-            allTypeNames.push_back(typeName);
-        }
+struct PokedexSnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    //checksum of everything following the header
+    uint64_t checksum;
+    PokedexSnapshotSource sources[POKEDEX_TABLES];
+    //sections follow the header, one per column in table order and then one for the string pool
+    uint32_t sectionCount;
+    uint32_t padding;
+};
+
+//mapped pokedex snapshot, kept for the lifetime of the program since the columns point into it
+void *pokedexSnapshotImage = NULL;
+size_t pokedexSnapshotImageSize = 0;
+
+/*
+ * Visits every column of every pokedex table, in the order they are stored in a pokedex snapshot.
+ */
+template <typename F>
+void forEachPokedexColumn(F visit) {
+
+    allPokemonInfo.forEachColumn(visit);
+    allMoves.forEachColumn(visit);
+    allPokemonMoves.forEachColumn(visit);
+    allPokemonSpecies.forEachColumn(visit);
+    allExperience.forEachColumn(visit);
+    allTypeNames.forEachColumn(visit);
+    allPokemonStats.forEachColumn(visit);
+    allPokemonTypes.forEachColumn(visit);
+    allTypeEfficacies.forEachColumn(visit);
+
+}
+
+/*
+ * FNV-1a over 64 bit words, finishing with any trailing bytes.
+ */
+uint64_t pokedexSnapshotChecksum(const char *data, size_t size) {
+
+    uint64_t hash = 14695981039346656037ULL;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ULL;
     }
-    else {
-        //file not opened successfully
-        return 1;
+    for (; i < size; i++) {
+        hash = (hash ^ (unsigned char) data[i]) * 1099511628211ULL;
     }
 
-    return 0;
+    return hash;
 
 }
 
-int storePokemonStats() {
+/*
+ * Records the size and modification time of a table's csv file (-1 if the file does not exist).
+ */
+void pokedexSnapshotSource(const char *source, PokedexSnapshotSource *snapshotSource) {
 
-    std::ifstream file;
-    file.open(filePath + "pokedex/pokedex/data/csv/pokemon_stats.csv");
-    if (file.is_open()) {
-        std::string pokemon_id, stat_id, base_stat, effort;
-        getline(file, pokemon_id, '\n');
-        while(getline(file, pokemon_id, ',')) {
-            getline(file, stat_id, ',');
-            getline(file, base_stat, ',');
-            getline(file, effort, '\n');
-            if (pokemon_id == "") {
-                pokemon_id = "-1";
-            }
-            if (stat_id == "") {
-                stat_id = "-1";
-            }
-            if (base_stat == "") {
-                base_stat = "-1";
-            }
-            if (effort == "") {
-                effort = "-1";
-            }
-            PokemonStat *stat = new PokemonStat(pokemon_id, stat_id, base_stat, effort);
-            allPokemonStats.push_back(stat);
-        }
+    struct stat fileStat;
+    if (stat((filePath + "pokedex/pokedex/data/csv/" + source).c_str(), &fileStat) == 0) {
+        snapshotSource->size = fileStat.st_size;
+        snapshotSource->modified = fileStat.st_mtime;
     }
     else {
-        //file not opened successfully
+        snapshotSource->size = -1;
+        snapshotSource->modified = -1;
+    }
+
+}
+
+template <typename T>
+void writeSnapshotSection(std::vector<char> &image, PokedexSnapshotSection *section, const T *values, uint32_t count) {
+
+    static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be plain data");
+    //keep every section aligned for its values
+    image.resize((image.size() + 7) & ~(size_t) 7);
+    section->offset = image.size();
+    section->size = (uint64_t) count * sizeof(T);
+    section->count = count;
+    section->recordSize = sizeof(T);
+    if (count > 0) {
+        image.insert(image.end(), (const char *) values, (const char *) (values + count));
+    }
+
+}
+
+template <typename T>
+bool mapSnapshotSection(const char *image, size_t imageSize, const PokedexSnapshotSection &section, Column<T> &column) {
+
+    if (section.recordSize != sizeof(T) || section.size != (uint64_t) section.count * sizeof(T)
+        || section.offset % alignof(T) != 0 || section.offset > imageSize || section.size > imageSize - section.offset) {
+        return false;
+    }
+    column.view((const T *) (image + section.offset), section.count);
+    return true;
+
+}
+
+/*
+ * Writes all columns as they are in memory to the pokedex snapshot so later runs can map it instead of reading csv.
+ */
+int compilePokedexSnapshot() {
+
+    PokedexSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, POKEDEX_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = POKEDEX_SNAPSHOT_VERSION;
+    for (int i = 0; i < POKEDEX_TABLES; i++) {
+        pokedexSnapshotSource(pokedexTableFiles[i], &header.sources[i]);
+    }
+    forEachPokedexColumn([&header](auto &) { header.sectionCount++; });
+    header.sectionCount++;
+
+    std::vector<PokedexSnapshotSection> sections(header.sectionCount);
+    std::vector<char> image(sizeof(header) + sections.size() * sizeof(PokedexSnapshotSection));
+    int section = 0;
+    forEachPokedexColumn([&image, &sections, &section](auto &column) {
+        writeSnapshotSection(image, &sections[section++], column.data(), column.size());
+    });
+    std::vector<char> strings(pokedexStrings.mapped, pokedexStrings.mapped + pokedexStrings.mappedSize);
+    strings.insert(strings.end(), pokedexStrings.added.begin(), pokedexStrings.added.end());
+    writeSnapshotSection(image, &sections[section], strings.data(), (uint32_t) strings.size());
+    memcpy(image.data() + sizeof(header), sections.data(), sections.size() * sizeof(PokedexSnapshotSection));
+    header.checksum = pokedexSnapshotChecksum(image.data() + sizeof(header), image.size() - sizeof(header));
+    memcpy(image.data(), &header, sizeof(header));
+
+    //write next to the snapshot and rename over it so a running game never maps a partly written file
+    std::string snapshotPath = filePath + POKEDEX_SNAPSHOT_PATH;
+    std::string temporaryPath = snapshotPath + ".tmp";
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return 1;
+    }
+    file.write(image.data(), image.size());
+    file.close();
+    if (!file || rename(temporaryPath.c_str(), snapshotPath.c_str()) != 0) {
+        remove(temporaryPath.c_str());
         return 1;
     }
 
@@ -1530,33 +3463,62 @@ int storePokemonStats() {
 
 }
 
-int storePokemonTypes() {
+/*
+ * Maps the pokedex snapshot and points every column at it.
+ * @return 0 if loaded, 1 if there is no snapshot, 2 if the snapshot is corrupt, of another version or out of date
+ */
+int loadPokedexSnapshot() {
 
-    std::ifstream file;
-    file.open(filePath + "pokedex/pokedex/data/csv/pokemon_types.csv");
-    if (file.is_open()) {
-        std::string pokemon_id, type_id, slot;
-        getline(file, pokemon_id, '\n');
-        while(getline(file, pokemon_id, ',')) {
-            getline(file, type_id, ',');
-            getline(file, slot, '\n');
-            if (pokemon_id == "") {
-                pokemon_id = "-1";
-            }
-            if (type_id == "") {
-                type_id = "-1";
-            }
-            if (slot == "") {
-                slot = "-1";
-            }
-            PokemonType *type = new PokemonType(pokemon_id, type_id, slot);
-            allPokemonTypes.push_back(type);
-        }
-    }
-    else {
-        //file not opened successfully
+    int fd = open((filePath + POKEDEX_SNAPSHOT_PATH).c_str(), O_RDONLY);
+    if (fd < 0) {
         return 1;
     }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || (size_t) fileStat.st_size < sizeof(PokedexSnapshotHeader)) {
+        close(fd);
+        return 2;
+    }
+    size_t imageSize = fileStat.st_size;
+    void *mapping = mmap(NULL, imageSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return 2;
+    }
+    const char *image = (const char *) mapping;
+
+    PokedexSnapshotHeader header;
+    memcpy(&header, image, sizeof(header));
+    bool valid = memcmp(header.magic, POKEDEX_SNAPSHOT_MAGIC, sizeof(header.magic)) == 0
+            && header.version == POKEDEX_SNAPSHOT_VERSION;
+    for (int i = 0; valid && i < POKEDEX_TABLES; i++) {
+        PokedexSnapshotSource source;
+        pokedexSnapshotSource(pokedexTableFiles[i], &source);
+        valid = source.size == header.sources[i].size && source.modified == header.sources[i].modified;
+    }
+    uint32_t sectionCount = 1;
+    forEachPokedexColumn([&sectionCount](auto &) { sectionCount++; });
+    valid = valid && header.sectionCount == sectionCount
+            && sizeof(header) + sectionCount * sizeof(PokedexSnapshotSection) <= imageSize
+            && header.checksum == pokedexSnapshotChecksum(image + sizeof(header), imageSize - sizeof(header));
+    const PokedexSnapshotSection *sections = (const PokedexSnapshotSection *) (image + sizeof(header));
+    int section = 0;
+    forEachPokedexColumn([image, imageSize, sections, &section, &valid](auto &column) {
+        valid = valid && mapSnapshotSection(image, imageSize, sections[section++], column);
+    });
+    const PokedexSnapshotSection *strings = sections + section;
+    valid = valid && strings->recordSize == 1 && strings->offset <= imageSize
+            && strings->size <= imageSize - strings->offset
+            && (strings->size == 0 || image[strings->offset + strings->size - 1] == '\0');
+    if (!valid) {
+        //leave no column pointing into the unmapped image
+        forEachPokedexColumn([](auto &column) { column.clear(); });
+        munmap(mapping, imageSize);
+        return 2;
+    }
+    pokedexStrings.mapped = image + strings->offset;
+    pokedexStrings.mappedSize = strings->count;
+    pokedexSnapshotImage = mapping;
+    pokedexSnapshotImageSize = imageSize;
 
     return 0;
 
@@ -1655,9 +3617,9 @@ int cheat_toggle_question() {
 
 int turn_based_movement() {
 
-    Tile *tile = world[current_tile_y][current_tile_x];
+    Tile *tile = world.get(current_tile_x, current_tile_y);
     static Character *character;
-    while ((character = (Character *) (heap_remove_min(&turn_heap)))) {
+    while ((character = tile->scheduler.pop())) {
         if (character->type_enum == PLAYER) {
             interface->clearUI();
             interface->addstrUI("It's your turn! Enter a command or press z for help!\n");
@@ -1668,259 +3630,258 @@ int turn_based_movement() {
                 return result;
             }
         }
-        else if (character->type_enum == RIVAL) {
-            if (character->defeated == 1) {
-                //no longer paths to PC
-                character->turn += MINIMUM_TURN;
-            } else {
-                //find a legal Point to change_tile to
-                int new_x;
-                int new_y;
-                int new_distance = INT_MAX;
-                for (int x = -1; x <= 1; x++) {
-                    for (int y = -1; y <= 1; y++) {
-                        int candidate_x = character->x + x;
-                        int candidate_y = character->y + y;
-                        if (candidate_x > 0 && candidate_x < TILE_WIDTH_X && candidate_y > 0 &&
-                            candidate_y < TILE_LENGTH_Y
-                            && rival_distance_tile[candidate_y][candidate_x] != INT_MAX
-                            && (tile->tile[candidate_y][candidate_x].character == NULL
-                                || (tile->tile[candidate_y][candidate_x].character->type_enum == PLAYER &&
-                                    character->defeated == 0))) {
-                            if (rival_distance_tile[candidate_y][candidate_x] < new_distance) {
-                                new_x = candidate_x;
-                                new_y = candidate_y;
-                                new_distance = rival_distance_tile[candidate_y][candidate_x];
-                            }
-                        }
-                    }
-                }
-                if (new_distance != INT_MAX) {
-                    //if legal Point to move to found, change_tile there
-                    move_character(character->x, character->y, new_x, new_y);
-                    character->turn += tile->tile[new_y][new_x].terrain.rival_weight;
-                } else {
-                    //no legal Point to change_tile to found
-                    character->turn += MINIMUM_TURN;
-                }
-            }
+        else {
+            move_trainer(tile, character);
         }
-        else if (character->type_enum == HIKER) {
-            if (character->defeated == 1) {
-                //no longer paths to PC
-                character->turn += MINIMUM_TURN;
-            }
-            else {
-                int new_x;
-                int new_y;
-                int new_distance = INT_MAX;
-                for (int x = -1; x <= 1; x++) {
-                    for (int y = -1; y <= 1; y++) {
-                        int candidate_x = character->x + x;
-                        int candidate_y = character->y + y;
-                        if (candidate_x > 0 && candidate_x < TILE_WIDTH_X && candidate_y > 0 &&
-                            candidate_y < TILE_LENGTH_Y
-                            && hiker_distance_tile[candidate_y][candidate_x] != INT_MAX
-                            && (tile->tile[candidate_y][candidate_x].character == NULL
-                                || (tile->tile[candidate_y][candidate_x].character->type_enum == PLAYER &&
-                                    character->defeated == 0))) {
-                            if (hiker_distance_tile[candidate_y][candidate_x] < new_distance) {
-                                new_x = candidate_x;
-                                new_y = candidate_y;
-                                new_distance = hiker_distance_tile[candidate_y][candidate_x];
-                            }
+        tile->scheduler.insert(character);
+    }
+
+    return 0;
+
+}
+
+/*
+ * Takes one turn of a trainer on tile: moves it as its type does and advances its turn by the cost of the move.
+ */
+int move_trainer(Tile *tile, Character *character) {
+
+    //trainers keep off the border, where only the gates are, so every cell around them is in the tile
+    if (character->type_enum == RIVAL) {
+        if (character->defeated == 1) {
+            //no longer paths to PC
+            character->turn += MINIMUM_TURN;
+        } else {
+            //find a legal Point to change_tile to
+            int new_x;
+            int new_y;
+            int new_distance = INT_MAX;
+            for (int x = -1; x <= 1; x++) {
+                for (int y = -1; y <= 1; y++) {
+                    int candidate_x = character->x + x;
+                    int candidate_y = character->y + y;
+                    if (candidate_x > 0 && candidate_x < TILE_WIDTH_X - 1 && candidate_y > 0 &&
+                        candidate_y < TILE_LENGTH_Y - 1
+                        && rival_distance_tile[candidate_y][candidate_x] != INT_MAX
+                        && (tile->character_at(candidate_x, candidate_y) == NULL
+                            || (tile->character_at(candidate_x, candidate_y)->type_enum == PLAYER &&
+                                character->defeated == 0))) {
+                        if (rival_distance_tile[candidate_y][candidate_x] < new_distance) {
+                            new_x = candidate_x;
+                            new_y = candidate_y;
+                            new_distance = rival_distance_tile[candidate_y][candidate_x];
                         }
                     }
                 }
-                if (new_distance != INT_MAX) {
-                    move_character(character->x, character->y, new_x, new_y);
-                    character->turn += tile->tile[new_y][new_x].terrain.hiker_weight;
-                } else {
-                    character->turn += MINIMUM_TURN;
-                }
             }
-        }
-        else if (character->type_enum == RANDOM_WALKER) {
-            int new_x = character->x + character->x_direction;
-            int new_y = character->y + character->y_direction;
-            //if we have a direction set and can continue in it
-            if (character->direction_set == 1 && new_x > 0 && new_x < TILE_WIDTH_X && new_y > 0 && new_y < TILE_LENGTH_Y
-                && tile->tile[new_y][new_x].terrain.rival_weight != INT_MAX
-                && (tile->tile[new_y][new_x].character == NULL
-                    || (tile->tile[new_y][new_x].character->type_enum == PLAYER && character->defeated == 0))) {
+            if (new_distance != INT_MAX) {
+                //if legal Point to move to found, change_tile there
                 move_character(character->x, character->y, new_x, new_y);
-                character->turn += tile->tile[new_y][new_x].terrain.rival_weight;
+                character->turn += tile->terrain_at(new_x, new_y).rival_weight;
+            } else {
+                //no legal Point to change_tile to found
+                character->turn += MINIMUM_TURN;
             }
-                //no direction set or can't continue in set direction
-            else {
-                //if at least 1 direction legal, choose randomly until legal direction is found
-                int has_possible_direction = 0;
+        }
+    }
+    else if (character->type_enum == HIKER) {
+        if (character->defeated == 1) {
+            //no longer paths to PC
+            character->turn += MINIMUM_TURN;
+        }
+        else {
+            int new_x;
+            int new_y;
+            int new_distance = INT_MAX;
+            for (int x = -1; x <= 1; x++) {
                 for (int y = -1; y <= 1; y++) {
-                    for (int x = -1; x <= 1; x++) {
-                        if (x != 0 || y != 0) {
-                            if (tile->tile[character->y + y][character->x + x].terrain.rival_weight != INT_MAX
-                                && (tile->tile[character->y + y][character->x + x].character == NULL
-                                    || (tile->tile[character->y + y][character->x + x].character->type_enum == PLAYER
-                                        && character->defeated == 0))) {
-                                has_possible_direction = 1;
-                            }
-                        }
-                    }
-                }
-                if (has_possible_direction == 1) {
-                    int found = 0;
-                    int x;
-                    int y;
-                    while (found == 0) {
-                        x = rand() % 3 - 1;
-                        y = rand() % 3 - 1;
-                        new_x = character->x + x;
-                        new_y = character->y + y;
-                        if ((x != 0 || y != 0) && new_x > 0 && new_x < TILE_WIDTH_X && new_y > 0 && new_y < TILE_LENGTH_Y
-                            && tile->tile[new_y][new_x].terrain.rival_weight != INT_MAX
-                            && (tile->tile[new_y][new_x].character == NULL
-                                || (tile->tile[new_y][new_x].character->type_enum == PLAYER && character->defeated == 0))) {
-                            found = 1;
+                    int candidate_x = character->x + x;
+                    int candidate_y = character->y + y;
+                    if (candidate_x > 0 && candidate_x < TILE_WIDTH_X - 1 && candidate_y > 0 &&
+                        candidate_y < TILE_LENGTH_Y - 1
+                        && hiker_distance_tile[candidate_y][candidate_x] != INT_MAX
+                        && (tile->character_at(candidate_x, candidate_y) == NULL
+                            || (tile->character_at(candidate_x, candidate_y)->type_enum == PLAYER &&
+                                character->defeated == 0))) {
+                        if (hiker_distance_tile[candidate_y][candidate_x] < new_distance) {
+                            new_x = candidate_x;
+                            new_y = candidate_y;
+                            new_distance = hiker_distance_tile[candidate_y][candidate_x];
                         }
                     }
-                    character->x_direction = x;
-                    character->y_direction = y;
-                    character->direction_set = 1;
-                    move_character(character->x, character->y, new_x, new_y);
-                    character->turn += tile->tile[new_y][new_x].terrain.rival_weight;
-                }
-                else {
-                    character->turn += MINIMUM_TURN;
                 }
             }
-        }
-        else if (character->type_enum == PACER) {
-            int new_x = character->x + character->x_direction;
-            int new_y = character->y + character->y_direction;
-            //change_tile in direction
-            if (character->direction_set == 1 && new_x > 0 && new_x < TILE_WIDTH_X && new_y > 0 && new_y < TILE_LENGTH_Y
-                && tile->tile[new_y][new_x].terrain.rival_weight != INT_MAX
-                && (tile->tile[new_y][new_x].character == NULL || tile->tile[new_y][new_x].character->type_enum == PLAYER)) {
-                move_character(character->x, character->y, new_x, new_y);
-                character->turn += tile->tile[new_y][new_x].terrain.rival_weight;
-            }
-                //reverse direction
-            else if (character->direction_set == 1) {
-                character->x_direction *= -1;
-                character->y_direction *= -1;
-                int new_x = character->x + character->x_direction;
-                int new_y = character->y + character->y_direction;
+            if (new_distance != INT_MAX) {
                 move_character(character->x, character->y, new_x, new_y);
-            }
-                //no direction yet
-            else {
-                //if at least 1 direction legal, choose randomly until legal direction is found
-                int has_possible_direction = 0;
-                for (int y = -1; y <= 1; y++) {
-                    for (int x = -1; x <= 1; x++) {
-                        if (x != 0 || y != 0) {
-                            if (tile->tile[character->y + y][character->x + x].terrain.rival_weight != INT_MAX
-                                && (tile->tile[character->y + y][character->x + x].character == NULL
-                                    || (tile->tile[character->y + y][character->x + x].character->type_enum == PLAYER
-                                        && character->defeated == 0))) {
-                                has_possible_direction = 1;
-                            }
-                        }
-                    }
-                }
-                if (has_possible_direction == 1) {
-                    int found = 0;
-                    int x;
-                    int y;
-                    while (found == 0) {
-                        x = rand() % 3 - 1;
-                        y = rand() % 3 - 1;
-                        new_x = character->x + x;
-                        new_y = character->y + y;
-                        if ((x != 0 || y != 0) && new_x > 0 && new_x < TILE_WIDTH_X && new_y > 0 && new_y < TILE_LENGTH_Y
-                            && tile->tile[new_y][new_x].terrain.rival_weight != INT_MAX
-                            && (tile->tile[new_y][new_x].character == NULL
-                                || (tile->tile[new_y][new_x].character->type_enum == PLAYER && character->defeated == 0))) {
-                            found = 1;
-                        }
-                    }
-                    character->x_direction = x;
-                    character->y_direction = y;
-                    character->direction_set = 1;
-                    move_character(character->x, character->y, new_x, new_y);
-                    character->turn += tile->tile[new_y][new_x].terrain.rival_weight;
-                }
-                else {
-                    character->turn += MINIMUM_TURN;
-                }
+                character->turn += tile->terrain_at(new_x, new_y).hiker_weight;
+            } else {
+                character->turn += MINIMUM_TURN;
             }
         }
-        else if (character->type_enum == WANDERER) {
-            int new_x = character->x + character->x_direction;
-            int new_y = character->y + character->y_direction;
-            if (character->direction_set == 1 && new_x > 0 && new_x < TILE_WIDTH_X && new_y > 0 && new_y < TILE_LENGTH_Y
-                && tile->tile[new_y][new_x].terrain.id == tile->tile[character->y][character->x].terrain.id
-                && (tile->tile[new_y][new_x].character == NULL
-                    || (tile->tile[new_y][new_x].character->type_enum == PLAYER && character->defeated == 0))) {
-                move_character(character->x, character->y, new_x, new_y);
-                character->turn += tile->tile[new_y][new_x].terrain.rival_weight;
+    }
+    else if (character->type_enum == RANDOM_WALKER || character->type_enum == PACER
+             || character->type_enum == WANDERER) {
+        int heading = character->direction_set == 1 ? direction_of(character->x_direction, character->y_direction) : -1;
+        int direction = walker_step(tile, character->type_enum, character->x, character->y, heading,
+                                    character->defeated == 1);
+        if (heading != -1) {
+            character->x_direction = direction_x[heading];
+            character->y_direction = direction_y[heading];
+            character->direction_set = 1;
+        }
+        if (direction != -1) {
+            int new_x = character->x + direction_x[direction];
+            int new_y = character->y + direction_y[direction];
+            if (tile->character_at(new_x, new_y) != NULL) {
+                //only the PC can be there
+                combat_trainer(character);
             }
             else {
-                //if at least 1 direction legal, choose randomly until legal direction is found
-                int has_possible_direction = 0;
-                for (int y = -1; y <= 1; y++) {
-                    for (int x = -1; x <= 1; x++) {
-                        if (x != 0 || y != 0) {
-                            if ((tile->tile[character->y + y][character->x + x].terrain.id
-                                 == tile->tile[character->y][character->x].terrain.id)
-                                && (tile->tile[character->y][character->x].character == NULL
-                                    || (tile->tile[character->y][character->x].character->type_enum == PLAYER && character->defeated == 0))) {
-                                has_possible_direction = 1;
-                            }
-                        }
-                    }
-                }
-                if (has_possible_direction == 1) {
-                    int found = 0;
-                    int x;
-                    int y;
-                    while (found == 0) {
-                        x = rand() % 3 - 1;
-                        y = rand() % 3 - 1;
-                        new_x = character->x + x;
-                        new_y = character->y + y;
-                        if ((x != 0 || y != 0) && new_x > 0 && new_x < TILE_WIDTH_X && new_y > 0 && new_y < TILE_LENGTH_Y
-                            && tile->tile[new_y][new_x].terrain.id == tile->tile[character->y][character->x].terrain.id
-                            && (tile->tile[new_y][new_x].character == NULL
-                                || (tile->tile[new_y][new_x].character->type_enum == PLAYER && character->defeated == 0))) {
-                            found = 1;
-                        }
-                    }
-                    character->x_direction = x;
-                    character->y_direction = y;
-                    character->direction_set = 1;
-                    move_character(character->x, character->y, new_x, new_y);
-                    character->turn += tile->tile[new_y][new_x].terrain.rival_weight;
-                }
-                else {
-                    character->turn += MINIMUM_TURN;
-                }
+                tile->move_occupant(character->x, character->y, new_x, new_y);
+                character->x = new_x;
+                character->y = new_y;
             }
+            character->turn += tile->terrain_at(new_x, new_y).rival_weight;
         }
-        else if (character->type_enum == STATIONARY) {
+        else {
             character->turn += MINIMUM_TURN;
         }
-        heap_insert(&turn_heap, character);
     }
-    heap_delete(&turn_heap);
+    else if (character->type_enum == STATIONARY) {
+        character->turn += MINIMUM_TURN;
+    }
 
     return 0;
 
 }
 
+/*
+ * The k-th legal direction in moves for a uniformly drawn k, the same choice as drawing directions until a legal one
+ * comes up but with a single draw.
+ */
+int pick_direction(uint8_t moves) {
+
+    int k = rand() % __builtin_popcount(moves);
+    while (k-- > 0) {
+        moves &= moves - 1;
+    }
+    return __builtin_ctz(moves);
+
+}
+
+/*
+ * One step of a random walker, pacer or wanderer on x, y going in direction heading (-1 if it has none yet).
+ * Walkers keep going while they can and otherwise pick a legal direction at random; pacers turn around instead,
+ * which takes their turn. Sets heading to where the trainer now faces.
+ *
+ * @return the direction to move in, -1 to wait
+ */
+int walker_step(const Tile *tile, enum character_type type, int x, int y, int &heading, bool defeated) {
+
+    uint8_t moves = tile->walker_moves(type, x, y, !defeated);
+    if (heading != -1) {
+        //pacers walk into the PC even once defeated
+        uint8_t ahead = type == PACER ? tile->walker_moves(type, x, y, true) : moves;
+        if (ahead & (1u << heading)) {
+            return heading;
+        }
+        if (type == PACER) {
+            heading = 7 - heading;
+            return -1;
+        }
+    }
+    if (moves == 0) {
+        return -1;
+    }
+    heading = pick_direction(moves);
+    return heading;
+
+}
+
+/*
+ * The walking trainers of one type on a tile, field by field, to step them all at once without going through their
+ * Characters. Only for tiles the PC is not playing on, where its cell counts as taken like any other.
+ */
+class WalkerBatch {
+public:
+    enum character_type type;
+    int count;
+    Character *characters[MAX_NUM_TRAINERS];
+    uint8_t x[MAX_NUM_TRAINERS];
+    uint8_t y[MAX_NUM_TRAINERS];
+    int8_t heading[MAX_NUM_TRAINERS];
+    bool defeated[MAX_NUM_TRAINERS];
+    int turn[MAX_NUM_TRAINERS];
+
+    void gather(const Tile *tile, enum character_type type) {
+
+        this->type = type;
+        count = 0;
+        for (Character *character : tile->characters) {
+            if (character->type_enum == type && count < MAX_NUM_TRAINERS) {
+                characters[count] = character;
+                x[count] = (uint8_t) character->x;
+                y[count] = (uint8_t) character->y;
+                heading[count] = (int8_t) (character->direction_set == 1
+                                           ? direction_of(character->x_direction, character->y_direction) : -1);
+                defeated[count] = character->defeated == 1;
+                turn[count] = character->turn;
+                count++;
+            }
+        }
+
+    }
+
+    /*
+     * Moves each trainer whose turn is before until one step.
+     *
+     * @return how many moved
+     */
+    int step(Tile *tile, int until) {
+
+        int stepped = 0;
+        for (int i = 0; i < count; i++) {
+            if (turn[i] >= until) {
+                continue;
+            }
+            int facing = heading[i];
+            int direction = walker_step(tile, type, x[i], y[i], facing, defeated[i]);
+            heading[i] = (int8_t) facing;
+            if (direction == -1) {
+                turn[i] += MINIMUM_TURN;
+            }
+            else {
+                int new_x = x[i] + direction_x[direction];
+                int new_y = y[i] + direction_y[direction];
+                tile->move_occupant(x[i], y[i], new_x, new_y);
+                x[i] = (uint8_t) new_x;
+                y[i] = (uint8_t) new_y;
+                turn[i] += tile->terrain_at(new_x, new_y).rival_weight;
+            }
+            stepped++;
+        }
+        return stepped;
+
+    }
+
+    void scatter() {
+
+        for (int i = 0; i < count; i++) {
+            characters[i]->x = x[i];
+            characters[i]->y = y[i];
+            if (heading[i] != -1) {
+                characters[i]->x_direction = direction_x[heading[i]];
+                characters[i]->y_direction = direction_y[heading[i]];
+                characters[i]->direction_set = 1;
+            }
+            characters[i]->turn = turn[i];
+        }
+
+    }
+};
+
 int player_turn() {
 
-    Tile *tile = world[current_tile_y][current_tile_x];
+    Tile *tile = world.get(current_tile_x, current_tile_y);
     int turn_completed = 0;
     int in_help = 0;
     int x = player_character->x;
@@ -1960,9 +3921,9 @@ int player_turn() {
             moving = 1;
             new_x--;
         } else if (input == '>') {
-            if (tile->tile[y][x].terrain.id == center->id) {
+            if (tile->terrain[y][x] == center->id) {
                 enter_center();
-            } else if (tile->tile[y][x].terrain.id == mart->id) {
+            } else if (tile->terrain[y][x] == mart->id) {
                 enter_mart();
             } else {
                 interface->clearUI();
@@ -1983,13 +3944,13 @@ int player_turn() {
             player_character->turn += MINIMUM_TURN;
             turn_completed = 1;
         } else if (input == 'B') {
-            bag_action(false, player_character->activePokemon.at(0), NULL);
+            bag_action(false, &player_character->activePokemon.at(0), NULL);
         } else if (input == 't') {
             NonPlayerCharacter *trainers [num_trainers];
             int count = 0;
             for (int i = 1; i < TILE_LENGTH_Y - 1; i++) {
                 for (int j = 1; j < TILE_WIDTH_X - 1; j++) {
-                    Character *character = tile->tile[i][j].character;
+                    Character *character = tile->character_at(j, i);
                     if (character != NULL && character->type_enum != PLAYER) {
                         trainers[count] = (NonPlayerCharacter *) character;
                         count++;
@@ -2324,36 +4285,35 @@ int player_turn() {
         //call movement function if moving
         if (moving == 1) {
             //if Terrain can be crossed
-            if (tile->tile[new_y][new_x].terrain.pc_weight == INT_MAX) {
+            if (tile->terrain_at(new_x, new_y).pc_weight == INT_MAX) {
                 interface->clearUI();
                 interface->addstrUI("You can't cross that kind of Terrain!\n");
                 print_tile_terrain(tile);
             }
                 //if there is an undefeated trainer there
-            else if (tile->tile[new_y][new_x].character != NULL && tile->tile[new_y][new_x].character->defeated != 0) {
+            else if (tile->character_at(new_x, new_y) != NULL && tile->character_at(new_x, new_y)->defeated != 0) {
                 interface->clearUI();
                 interface->addstrUI("You have already defeated that trainer so they are too scared to battle you again!");
                 print_tile_terrain(tile);
             }
                 //if you are exiting the map
             else if (new_y == 0 || new_y == TILE_LENGTH_Y - 1 || new_x == 0 || new_x == TILE_WIDTH_X - 1) {
-                if (change_tile(tile->x + new_x - x, tile->y + new_y - y) == 0) {
-                    tile->tile[y][x].character = NULL;
-                    //Tile in this function is new Tile
-                    tile = world[current_tile_y][current_tile_x];
-                    //successfully changed tiles
-                    //updates PC coordinates
-                    //todo: RUN BUG: going back to old map SOMETIMES creates a new map replacing old map: debug by writing map coords when in map
-                    if (new_x == 0) {
-                        player_character->x = TILE_WIDTH_X - 2;
-                    } else if (new_x == TILE_WIDTH_X - 1) {
-                        player_character->x = 1;
-                    } else if (new_y == 0) {
-                        player_character->y = TILE_LENGTH_Y - 2;
-                    } else if (new_y == TILE_LENGTH_Y - 1) {
-                        player_character->y = 1;
-                    }
-                    tile->tile[player_character->y][player_character->x].character = player_character;
+                //cell the PC enters the new tile at
+                int entry_x = x;
+                int entry_y = y;
+                //todo: RUN BUG: going back to old map SOMETIMES creates a new map replacing old map: debug by writing map coords when in map
+                if (new_x == 0) {
+                    entry_x = TILE_WIDTH_X - 2;
+                } else if (new_x == TILE_WIDTH_X - 1) {
+                    entry_x = 1;
+                } else if (new_y == 0) {
+                    entry_y = TILE_LENGTH_Y - 2;
+                } else if (new_y == TILE_LENGTH_Y - 1) {
+                    entry_y = 1;
+                }
+                if (change_tile(tile->x + new_x - x, tile->y + new_y - y, entry_x, entry_y) == 0) {
+                    //Tile in this function is new Tile, with the PC already placed on it
+                    tile = world.get(current_tile_x, current_tile_y);
                     //refactors trainer distance tiles
                     dijkstra(tile, RIVAL);
                     dijkstra(tile, HIKER);
@@ -2371,10 +4331,10 @@ int player_turn() {
             }
             else {
                 move_character(x, y, new_x, new_y);
-                player_character->turn += tile->tile[new_y][new_x].terrain.pc_weight;
-                //recreate distance tiles for new PC location
-                dijkstra(tile, RIVAL);
-                dijkstra(tile, HIKER);
+                player_character->turn += tile->terrain_at(new_x, new_y).pc_weight;
+                //update distance tiles for new PC location
+                update_distances(tile, RIVAL, x, y);
+                update_distances(tile, HIKER, x, y);
                 turn_completed = 1;
             }
         }
@@ -2385,10 +4345,10 @@ int player_turn() {
 
 int move_character(int x, int y, int new_x, int new_y) {
 
-    Tile *tile = world[current_tile_y][current_tile_x];
-    Point point = tile->tile[new_y][new_x];
-    Character *from_character = tile->tile[y][x].character;
-    Character *to_character = tile->tile[new_y][new_x].character;
+    Tile *tile = world.get(current_tile_x, current_tile_y);
+    int terrain = tile->terrain[new_y][new_x];
+    Character *from_character = tile->character_at(x, y);
+    Character *to_character = tile->character_at(new_x, new_y);
     //if moving onto character
     if (to_character != NULL) {
         //pc-trainer combat_trainer instigated by either party
@@ -2413,16 +4373,15 @@ int move_character(int x, int y, int new_x, int new_y) {
         }
     }
     else {
-        tile->tile[y][x].character->x = new_x;
-        tile->tile[y][x].character->y = new_y;
-        Character *temp_character = tile->tile[y][x].character;
-        tile->tile[y][x].character = NULL;
-        tile->tile[new_y][new_x].character = temp_character;
+        from_character->x = new_x;
+        from_character->y = new_y;
+        tile->set_character(x, y, NULL);
+        tile->set_character(new_x, new_y, from_character);
     }
-    if (from_character->type_enum == PLAYER && point.terrain.id == grass->id) {
+    if (from_character->type_enum == PLAYER && terrain == grass->id) {
         if (rand() % INVERSE_POKEMON_ENCOUNTER_CHANCE == 0) {
-            Pokemon *pokemon = create_pokemon();
-            combat_pokemon(pokemon);
+            Pokemon pokemon = create_pokemon(current_tile_x, current_tile_y);
+            combat_pokemon(&pokemon);
         }
     }
     return 0;
@@ -2438,8 +4397,8 @@ int combat_trainer(Character *opponent) {
     bool victory = false;
     bool battleOver = false;
     int numRunAttempts = 0;
-    Pokemon *selectedPokemon = player_character->activePokemon.at(0);
-    Pokemon *trainerSelectedPokemon = opponent->activePokemon.at(0);
+    Pokemon *selectedPokemon = &player_character->activePokemon.at(0);
+    Pokemon *trainerSelectedPokemon = &opponent->activePokemon.at(0);
     while (!battleOver) {
         bool actionSelected = false;
         int moveIndex = -1;
@@ -2502,19 +4461,21 @@ int combat_trainer(Character *opponent) {
             if (trainerSelectedPokemon->knockedOut) {
                 trainerMoveIndex = -1;
                 for (int i = 0; i < opponent->activePokemon.size(); i++) {
-                    if (!opponent->activePokemon.at(i)->knockedOut) {
-                        trainerSelectedPokemon = opponent->activePokemon.at(i);
+                    if (!opponent->activePokemon.at(i).knockedOut) {
+                        trainerSelectedPokemon = &opponent->activePokemon.at(i);
                         break;
                     }
                 }
             }
             else {
-                trainerMoveIndex = rand() % trainerSelectedPokemon->moves.size();
+                trainerMoveIndex = rand() % trainerSelectedPokemon->moveCount;
             }
-            doCombat(selectedPokemon, moveIndex, trainerSelectedPokemon, trainerMoveIndex, true);
+            BattleLog log;
+            doCombat(selectedPokemon, moveIndex, trainerSelectedPokemon, trainerMoveIndex, true, log);
+            renderBattleLog(log);
             bool noActiveTrainerPokemonRemaining = true;
             for (int i = 0; i < opponent->activePokemon.size(); i++) {
-                if (!opponent->activePokemon.at(i)->knockedOut) {
+                if (!opponent->activePokemon.at(i).knockedOut) {
                     noActiveTrainerPokemonRemaining = false;
                     break;
                 }
@@ -2526,7 +4487,7 @@ int combat_trainer(Character *opponent) {
             else {
                 bool noActivePokemonRemaining = true;
                 for (int i = 0; i < player_character->activePokemon.size(); i++) {
-                    if (!player_character->activePokemon.at(i)->knockedOut) {
+                    if (!player_character->activePokemon.at(i).knockedOut) {
                         noActivePokemonRemaining = false;
                         break;
                     }
@@ -2655,10 +4616,11 @@ int bossBattleFinished(bool victory) {
 
 }
 
-Pokemon * create_pokemon() {
+Pokemon create_pokemon(int tile_x, int tile_y) {
 
-    PokemonInfo *pokemonInfo = allPokemonInfo[rand() % allPokemonInfo.size()];
-    double distanceDouble = distance(current_tile_x, current_tile_y, WORLD_CENTER_X, WORLD_CENTER_Y);
+    int species = random_below(allPokemonInfo.size());
+    const PokemonIndexEntry *entry = &pokemonIndex.entries[species];
+    double distanceDouble = distance(tile_x, tile_y, WORLD_CENTER_X, WORLD_CENTER_Y);
     int distance = trunc(distanceDouble);
     int minLevel;
     int maxLevel;
@@ -2679,70 +4641,61 @@ Pokemon * create_pokemon() {
     if (minLevel == maxLevel) {
         level = minLevel;
     } else {
-        level = minLevel + rand() % (maxLevel - minLevel);
+        level = minLevel + random_below(maxLevel - minLevel);
     }
-    PokemonMove *pokemonMove = allPokemonMoves[0];
-    int found = 0;
-    while (found == 0) {
-        pokemonMove = allPokemonMoves[rand() % allPokemonMoves.size()];
-        if (pokemonMove->pokemon_id == pokemonInfo->species_id && pokemonMove->pokemon_move_method_id == 1) {
-            found = 1;
-        }
+    //level up moves learned by this level, at least the first one
+    uint32_t learned = 0;
+    while (learned < entry->levelUpMoveCount
+           && pokemonIndex.levelUpMoves[entry->firstLevelUpMove + learned].level <= level) {
+        learned++;
     }
-    int base_health;
-    int base_attack;
-    int base_defense;
-    int base_speed;
-    int base_special_attack;
-    int base_special_defense;
-    for (int i = 0; i < (int) allPokemonStats.size(); i += 6) {
-        if (allPokemonStats[i]->pokemon_id == pokemonInfo->id) {
-            base_health = allPokemonStats[i]->base_stat;
-            base_attack = allPokemonStats[i + 1]->base_stat;
-            base_defense = allPokemonStats[i + 2]->base_stat;
-            base_speed = allPokemonStats[i + 3]->base_stat;
-            base_special_attack = allPokemonStats[i + 4]->base_stat;
-            base_special_defense = allPokemonStats[i + 5]->base_stat;
-            break;
-        }
+    if (learned == 0 && entry->levelUpMoveCount > 0) {
+        learned = 1;
     }
-    //todo: BUG: need to check if move level is not above pokemon level
-    //todo: BUG: move2 is always null because legal Moves is always a single element. Maybe matching moves incorrectly?
-        //todo: ^ match pokemon_moves rather than moves. Then find move in moves based off of accepted pokemon_moves.
-    std::vector<Move *> legalMoves;
-    for (int i = 0; i < (int) allMoves.size(); i++) {
-        if (allMoves[i]->id == pokemonMove->move_id) {
-            legalMoves.push_back(allMoves[i]);
-        }
+    std::vector<int> moveIDs;
+    if (learned == 0) {
+        moveIDs.push_back(STRUGGLE_MOVE_ID);
     }
-    std::vector<Move *> moves;
-    if (legalMoves.size() == 1) {
-        moves.push_back(legalMoves[0]);
+    else if (learned == 1) {
+        moveIDs.push_back(pokemonIndex.levelUpMoves[entry->firstLevelUpMove].move_id);
     }
     else {
-        Move *move1 = legalMoves[rand() % legalMoves.size()];
-        Move *move2 = legalMoves[rand() % legalMoves.size()];
-        while (move2 == move1) {
-            move2 = legalMoves[rand() % legalMoves.size()];
+        uint32_t move1 = random_below(learned);
+        uint32_t move2 = random_below(learned - 1);
+        if (move2 >= move1) {
+            move2++;
+        }
+        moveIDs.push_back(pokemonIndex.levelUpMoves[entry->firstLevelUpMove + move1].move_id);
+        moveIDs.push_back(pokemonIndex.levelUpMoves[entry->firstLevelUpMove + move2].move_id);
+    }
+    std::vector<int> moves;
+    for (int i = 0; i < (int) moveIDs.size(); i++) {
+        if (moveRegistry.contains(moveIDs[i])) {
+            moves.push_back(moveIDs[i]);
         }
-        moves.push_back(move1);
-        moves.push_back(move2);
     }
-    bool male = rand() % 2;
+    //battles pick a move modulo moveCount, so a pokemon whose moves are all unknown still struggles
+    if (moves.empty()) {
+        moves.push_back(STRUGGLE_MOVE_ID);
+    }
+
+    return create_pokemon_of(species, level, moves);
+
+}
+
+/*
+ * @return a pokemon of species, its position in pokemonIndex.entries, at level knowing moves, with random IVs, gender
+ * and shininess
+ */
+Pokemon create_pokemon_of(int species, int level, const std::vector<int> &moves) {
+
+    bool male = random_below(2);
     bool shiny = false;
-    if (rand() % 8192 == 0) {
+    if (random_below(8192) == 0) {
         shiny = true;
     }
 
-    Pokemon *pokemon = new Pokemon(pokemonInfo, base_health, base_attack, base_defense, base_speed, base_special_attack,
-                                   base_special_defense, level, moves, male, shiny);
-    for (int i = 0; i < allPokemonTypes.size(); i++) {
-        PokemonType *pokemonType = allPokemonTypes.at(i);
-        if (pokemonType->pokemon_id == pokemon->pokemonInfo->id) {
-            pokemon->typeIDs.push_back(pokemonType->type_id);
-        }
-    }
-    return pokemon;
+    return Pokemon(species, level, moves, male, shiny);
 
 }
 
@@ -2751,7 +4704,7 @@ int combat_pokemon(Pokemon *wildPokemon) {
     bool victory = false;
     bool battleOver = false;
     int numRunAttempts = 0;
-    Pokemon *selectedPokemon = player_character->activePokemon.at(0);
+    Pokemon *selectedPokemon = &player_character->activePokemon.at(0);
     while (!battleOver) {
         bool actionSelected = false;
         int moveIndex = -1;
@@ -2763,7 +4716,7 @@ int combat_pokemon(Pokemon *wildPokemon) {
                 //moves index = moveInput - 1
                 interface->clearUI();
                 interface->addstrUI("You have found a wild ");
-                interface->addstrUI(wildPokemon->pokemonInfo->name.c_str());
+                interface->addstrUI(wildPokemon->info().getName());
                 interface->addstrUI("!\n");
                 interface->addstrUI(
                         "Input a command: 'F' to fight; 'S' to switch pokemon; 'B' to open your bag; 'R' to run away");
@@ -2821,14 +4774,16 @@ int combat_pokemon(Pokemon *wildPokemon) {
         }
         if (!battleOver) {
             int wildPokemonMoveIndex = getWildPokemonMove(wildPokemon);
-            doCombat(selectedPokemon, moveIndex, wildPokemon, wildPokemonMoveIndex, false);
+            BattleLog log;
+            doCombat(selectedPokemon, moveIndex, wildPokemon, wildPokemonMoveIndex, false, log);
+            renderBattleLog(log);
             if (wildPokemon->knockedOut) {
                 victory = true;
                 battleOver = true;
             } else {
                 bool noActivePokemonRemaining = true;
                 for (int i = 0; i < player_character->activePokemon.size(); i++) {
-                    if (!player_character->activePokemon.at(i)->knockedOut) {
+                    if (!player_character->activePokemon.at(i).knockedOut) {
                         noActivePokemonRemaining = false;
                         break;
                     }
@@ -2843,7 +4798,7 @@ int combat_pokemon(Pokemon *wildPokemon) {
     if (victory) {
         interface->clearUI();
         interface->addstrUI("Victory! You have defeated a wild ");
-        interface->addstrUI(wildPokemon->pokemonInfo->name.c_str());
+        interface->addstrUI(wildPokemon->info().getName());
         interface->addstrUI("! Press esc to continue.");
         interface->refreshUI();
         while (interface->getchUI() != 27) {
@@ -2855,7 +4810,7 @@ int combat_pokemon(Pokemon *wildPokemon) {
     else {
         interface->clearUI();
         interface->addstrUI("Defeat! You have been defeated by a wild ");
-        interface->addstrUI(wildPokemon->pokemonInfo->name.c_str());
+        interface->addstrUI(wildPokemon->info().getName());
         interface->addstrUI("! Press esc to continue.");
         interface->refreshUI();
         while (interface->getchUI() != 27) {
@@ -2871,12 +4826,16 @@ int combat_pokemon(Pokemon *wildPokemon) {
 
 int getWildPokemonMove(Pokemon *wildPokemon) {
 
-    return rand() % wildPokemon->moves.size();
+    return rand() % wildPokemon->moveCount;
 
 }
 
+/*
+ * Plays a battle turn in which each pokemon uses the move at its move index, or does nothing for -1, logging what happens
+ * to log. Touches no screen, so it runs without a terminal.
+ */
 int doCombat(Pokemon *friendlyPokemon, int friendlyPokemonMoveIndex, Pokemon *enemyPokemon, int enemyPokemonMoveIndex,
-             bool trainerBattle) {
+             bool trainerBattle, BattleLog &log) {
 
     //determine attack order
     bool friendlyPokemonFirst;
@@ -2894,8 +4853,8 @@ int doCombat(Pokemon *friendlyPokemon, int friendlyPokemonMoveIndex, Pokemon *en
     }
     else {
         bothAttack = true;
-        int friendlyPokemonPriority = friendlyPokemon->moves.at(friendlyPokemonMoveIndex)->priority;
-        int wildPokemonPriority = enemyPokemon->moves.at(enemyPokemonMoveIndex)->priority;
+        int friendlyPokemonPriority = friendlyPokemon->getMove(friendlyPokemonMoveIndex).priority;
+        int wildPokemonPriority = enemyPokemon->getMove(enemyPokemonMoveIndex).priority;
         if (friendlyPokemonPriority > wildPokemonPriority) {
             friendlyPokemonFirst = true;
         } else if (wildPokemonPriority > friendlyPokemonPriority) {
@@ -2908,7 +4867,7 @@ int doCombat(Pokemon *friendlyPokemon, int friendlyPokemonMoveIndex, Pokemon *en
             } else if (wildPokemonSpeed > friendlyPokemonSpeed) {
                 friendlyPokemonFirst = false;
             } else {
-                if (rand() % 2 == 0) {
+                if (random_below(2) == 0) {
                     friendlyPokemonFirst = true;
                 } else {
                     friendlyPokemonFirst = false;
@@ -2919,10 +4878,10 @@ int doCombat(Pokemon *friendlyPokemon, int friendlyPokemonMoveIndex, Pokemon *en
 
     //do faster attack
     if (friendlyPokemonFirst) {
-        attack(friendlyPokemon, friendlyPokemonMoveIndex, enemyPokemon, trainerBattle);
+        attack(friendlyPokemon, friendlyPokemonMoveIndex, enemyPokemon, trainerBattle, log);
     }
     else {
-        attack(enemyPokemon, enemyPokemonMoveIndex, friendlyPokemon, trainerBattle);
+        attack(enemyPokemon, enemyPokemonMoveIndex, friendlyPokemon, trainerBattle, log);
     }
 
     //if either pokemon is at 0 health, the second attacker is at 0 health, so we end the battle
@@ -2932,9 +4891,9 @@ int doCombat(Pokemon *friendlyPokemon, int friendlyPokemonMoveIndex, Pokemon *en
     //else do the second attack
     if (bothAttack) {
         if (!friendlyPokemonFirst) {
-            attack(friendlyPokemon, friendlyPokemonMoveIndex, enemyPokemon, trainerBattle);
+            attack(friendlyPokemon, friendlyPokemonMoveIndex, enemyPokemon, trainerBattle, log);
         } else {
-            attack(enemyPokemon, enemyPokemonMoveIndex, friendlyPokemon, trainerBattle);
+            attack(enemyPokemon, enemyPokemonMoveIndex, friendlyPokemon, trainerBattle, log);
         }
     }
 
@@ -2942,104 +4901,165 @@ int doCombat(Pokemon *friendlyPokemon, int friendlyPokemonMoveIndex, Pokemon *en
 
 }
 
-int attack(Pokemon *attackingPokemon, int moveIndex, Pokemon *defendingPokemon, bool trainerBattle) {
-
-    Move *move = attackingPokemon->moves.at(moveIndex);
+/*
+ * Attacks defendingPokemon with the move at moveIndex of attackingPokemon, logging the move, the damage or miss and, if
+ * it faints, the experience attackingPokemon gains.
+ */
+int attack(Pokemon *attackingPokemon, int moveIndex, Pokemon *defendingPokemon, bool trainerBattle, BattleLog &log) {
 
-    //determine if hits or evaded
-    bool hit = rand() % 100 < move->accuracy;
+    const Move *move = &attackingPokemon->getMove(moveIndex);
+    log.add(BATTLE_MOVE_USED, attackingPokemon).moveID = move->id;
 
-    int line = 0;
-    interface->clearUI();
-    interface->mvaddstrUI(line, 0, attackingPokemon->pokemonInfo->name.c_str());
-    interface->addstrUI(" used ");
-    interface->addstrUI(move->name.c_str());
-    interface->addstrUI("!");
-    line++;
-    if (hit) {
-        //do damage
-        int critical = 1;
-        if (rand() % 256 < attackingPokemon->speed_iv / 2) {
-            critical = 1.5;
-        }
-        int stab = 1;
-        bool typeMatch = false;
-        for (int i = 0; i < attackingPokemon->typeIDs.size(); i++) {
-            if (attackingPokemon->typeIDs.at(i) == move->type_id) {
-                typeMatch = true;
-                break;
-            }
-        }
-        if (typeMatch) {
-            stab = 1.5;
-        }
-        double type = 1;
-        //todo: BUG: if move->power == -1 (not provided) set damageDouble to 0
-        double damageDouble = (((2.0 * attackingPokemon->level / 5 + 2)
-                * move->power * attackingPokemon->getAttack() / defendingPokemon->getDefense()) / 50 + 2)
-                * critical * (rand() % 16 + 85) / 100 * stab * type;
-        int damage = (int) damageDouble;
-        int damageDealt = defendingPokemon->takeDamage(damage);
+    //determine if hits or evaded, moves without an accuracy never miss
+    bool hit = move->accuracy == POKEDEX_NULL || random_below(100) < move->accuracy;
+    if (!hit) {
+        log.add(BATTLE_MISSED, defendingPokemon);
+        return 0;
+    }
 
-        //print hit message (different if critical hit or results in knock out)
-        if (type != 1) {
-            interface->mvaddstrUI(line, 0, "It was ");
-            if (type == 0) {
-                interface->addstrUI("incredibly ");
-            }
-            else if (type == 0.25 || type == 4) {
-                interface->addstrUI("super ");
-            }
-            if (type < 1) {
-                interface->addstrUI("ineffective");
-            }
-            else {
-                //type > 1
-                interface->addstrUI("effective");
-            }
-            interface->addstrUI("!");
-            line++;
-        }
-        interface->mvaddstrUI(line, 0, defendingPokemon->pokemonInfo->name.c_str());
-        interface->addstrUI(" took ");
-        interface->addstrUI(std::to_string(damage).c_str());
-        interface->addstrUI(" damage!");
-        line++;
+    //do damage
+    int critical = 1;
+    if (random_below(256) < attackingPokemon->getIV(STAT_SPEED) / 2) {
+        critical = 1.5;
     }
-    else {
-        //print no hit message
-        interface->mvaddstrUI(line, 0, "It missed!");
-        line++;
+    int stab = 1;
+    if (attackingPokemon->hasType(move->type_id)) {
+        stab = 1.5;
     }
-    interface->mvaddstrUI(line, 0, defendingPokemon->pokemonInfo->name.c_str());
-    interface->addstrUI(" health: ");
-    interface->addstrUI(std::to_string(defendingPokemon->getHealth()).c_str());
-    interface->addstrUI(" / ");
-    interface->addstrUI(std::to_string(defendingPokemon->maxHealth).c_str());
-    line++;
+    double type = typeEfficacy.against(move->type_id, defendingPokemon->typeIDs[0], defendingPokemon->typeIDs[1]);
+    //moves without a power do no damage
+    double damageDouble = 0;
+    if (move->power != POKEDEX_NULL) {
+        damageDouble = (((2.0 * attackingPokemon->level / 5 + 2)
+                * move->power * attackingPokemon->getAttack() / defendingPokemon->getDefense()) / 50 + 2)
+                * critical * (random_below(16) + 85) / 100 * stab * type;
+    }
+    int damage = (int) damageDouble;
+    defendingPokemon->takeDamage(damage);
+    BattleEvent &damageEvent = log.add(BATTLE_DAMAGE, defendingPokemon);
+    damageEvent.amount = damage;
+    damageEvent.effectiveness = type;
+
     if (defendingPokemon->knockedOut) {
-        interface->mvaddstrUI(line, 0, defendingPokemon->pokemonInfo->name.c_str());
-        interface->addstrUI(" has fainted!");
-        line++;
+        log.add(BATTLE_FAINTED, defendingPokemon);
         double battleTypeModifier = 1.0;
         if (trainerBattle) {
             battleTypeModifier = 1.5;
         }
-        int baseExperience = defendingPokemon->pokemonInfo->base_experience;
+        int baseExperience = defendingPokemon->info().base_experience;
+        if (baseExperience == POKEDEX_NULL) {
+            baseExperience = 0;
+        }
         int level = defendingPokemon->level;
         int experience = (int) (battleTypeModifier * baseExperience * level / 7);
-        interface->mvaddstrUI(line, 0, attackingPokemon->pokemonInfo->name.c_str());
-        interface->addstrUI(" has gained ");
-        interface->addstrUI(std::to_string(experience).c_str());
-        interface->addstrUI(" experience!");
-        interface->refreshUI();
-        awaitInputEscape();
+        log.add(BATTLE_EXPERIENCE, attackingPokemon).amount = experience;
         if (attackingPokemon->gainExperience(experience)) {
-            levelUp(attackingPokemon);
+            log.add(BATTLE_LEVEL_UP, attackingPokemon).amount = attackingPokemon->level;
         }
     }
-    interface->refreshUI();
-    awaitInputEscape();
+
+    return 0;
+
+}
+
+/*
+ * Shows the events of log the way battles always have: a screen per attack, with a pause after the experience gained
+ * and a level up screen.
+ */
+int renderBattleLog(const BattleLog &log) {
+
+    int line = 0;
+    bool screenOpen = false;
+    for (int i = 0; i < log.size; i++) {
+        const BattleEvent &event = log.events[i];
+        switch (event.type) {
+            case BATTLE_MOVE_USED:
+                if (screenOpen) {
+                    interface->refreshUI();
+                    awaitInputEscape();
+                }
+                line = 0;
+                interface->clearUI();
+                interface->mvaddstrUI(line, 0, event.pokemon->info().getName());
+                interface->addstrUI(" used ");
+                interface->addstrUI(moveRegistry.get(event.moveID).getName());
+                interface->addstrUI("!");
+                line++;
+                screenOpen = true;
+                break;
+            case BATTLE_DAMAGE:
+            case BATTLE_MISSED:
+                //print hit message (different if critical hit or results in knock out)
+                if (event.type == BATTLE_MISSED) {
+                    interface->mvaddstrUI(line, 0, "It missed!");
+                    line++;
+                }
+                else {
+                    double type = event.effectiveness;
+                    if (type != 1) {
+                        interface->mvaddstrUI(line, 0, "It was ");
+                        if (type == 0) {
+                            interface->addstrUI("incredibly ");
+                        }
+                        else if (type == 0.25 || type == 4) {
+                            interface->addstrUI("super ");
+                        }
+                        if (type < 1) {
+                            interface->addstrUI("ineffective");
+                        }
+                        else {
+                            //type > 1
+                            interface->addstrUI("effective");
+                        }
+                        interface->addstrUI("!");
+                        line++;
+                    }
+                    interface->mvaddstrUI(line, 0, event.pokemon->info().getName());
+                    interface->addstrUI(" took ");
+                    interface->addstrUI(std::to_string(event.amount).c_str());
+                    interface->addstrUI(" damage!");
+                    line++;
+                }
+                interface->mvaddstrUI(line, 0, event.pokemon->info().getName());
+                interface->addstrUI(" health: ");
+                interface->addstrUI(std::to_string(event.health).c_str());
+                interface->addstrUI(" / ");
+                interface->addstrUI(std::to_string(event.maxHealth).c_str());
+                line++;
+                break;
+            case BATTLE_FAINTED:
+                interface->mvaddstrUI(line, 0, event.pokemon->info().getName());
+                interface->addstrUI(" has fainted!");
+                line++;
+                break;
+            case BATTLE_EXPERIENCE:
+                interface->mvaddstrUI(line, 0, event.pokemon->info().getName());
+                interface->addstrUI(" has gained ");
+                interface->addstrUI(std::to_string(event.amount).c_str());
+                interface->addstrUI(" experience!");
+                interface->refreshUI();
+                awaitInputEscape();
+                break;
+            case BATTLE_LEVEL_UP:
+                levelUp(event.pokemon);
+                break;
+            case BATTLE_RAN_AWAY:
+            case BATTLE_RUN_FAILED:
+                if (screenOpen) {
+                    interface->refreshUI();
+                    awaitInputEscape();
+                }
+                interface->clearUI();
+                interface->addstrUI(event.type == BATTLE_RAN_AWAY ? "You successfully ran away!"
+                                                                  : "You were too slow to run away! Maybe you'll be able to next time!");
+                screenOpen = true;
+                break;
+        }
+    }
+    if (screenOpen) {
+        interface->refreshUI();
+        awaitInputEscape();
+    }
 
     return 0;
 
@@ -3068,11 +5088,11 @@ int fight_action(Pokemon *selectedPokemon) {
     interface->clearUI();
     interface->mvaddstrUI(line, 0,"Select a move by inputting the number corresponding to the move or press esc to go back.");
     line++;
-    for (int i = 0; i < selectedPokemon->moves.size(); i++) {
+    for (int i = 0; i < selectedPokemon->moveCount; i++) {
         interface->mvaddstrUI(line, 0, "Move ");
         interface->addstrUI(std::to_string(i+1).c_str());
         interface->addstrUI(": ");
-        interface->addstrUI(selectedPokemon->moves.at(i)->name.c_str());
+        interface->addstrUI(selectedPokemon->getMove(i).getName());
         line++;
     }
     interface->refreshUI();
@@ -3086,18 +5106,18 @@ int fight_action(Pokemon *selectedPokemon) {
             interface->mvaddstrUI(line, 0, &input);
             interface->addstrUI("The active pokemon has fainted and cannot make any moves. Press esc to go back.");
             line++;
-            for (int i = 0; i < selectedPokemon->moves.size(); i++) {
+            for (int i = 0; i < selectedPokemon->moveCount; i++) {
                 interface->mvaddstrUI(line, 0, "Move ");
                 interface->addstrUI(std::to_string(i+1).c_str());
                 interface->addstrUI(": ");
-                interface->addstrUI(selectedPokemon->moves.at(i)->name.c_str());
+                interface->addstrUI(selectedPokemon->getMove(i).getName());
                 line++;
             }
             interface->refreshUI();
         }
         else {
             int inputInt = input - '0';
-            if (inputInt > 0 && inputInt <= selectedPokemon->moves.size()) {
+            if (inputInt > 0 && inputInt <= selectedPokemon->moveCount) {
                 return inputInt - 1;
             } else if (input == 27) {
                 return -1;
@@ -3107,11 +5127,11 @@ int fight_action(Pokemon *selectedPokemon) {
                 interface->mvaddstrUI(line, 0, &input);
                 interface->addstrUI(" is not a valid input. Press a number corresponding to a move or esc to go back.");
                 line++;
-                for (int i = 0; i < selectedPokemon->moves.size(); i++) {
+                for (int i = 0; i < selectedPokemon->moveCount; i++) {
                     interface->mvaddstrUI(line, 0, "Move ");
                     interface->addstrUI(std::to_string(i + 1).c_str());
                     interface->addstrUI(": ");
-                    interface->addstrUI(selectedPokemon->moves.at(i)->name.c_str());
+                    interface->addstrUI(selectedPokemon->getMove(i).getName());
                     line++;
                 }
                 interface->refreshUI();
@@ -3128,7 +5148,7 @@ Pokemon *switch_pokemon_action(Pokemon *selectedPokemon, bool mustSwitch) {
     if (mustSwitch) {
         bool allKnockedOut = true;
         for (int i = 0; i < player_character->activePokemon.size(); i++) {
-            if (!player_character->activePokemon.at(i)->knockedOut) {
+            if (!player_character->activePokemon.at(i).knockedOut) {
                 allKnockedOut = false;
                 break;
             }
@@ -3153,13 +5173,13 @@ Pokemon *switch_pokemon_action(Pokemon *selectedPokemon, bool mustSwitch) {
     for (int i = 0; i < player_character->activePokemon.size(); i++) {
         interface->mvaddstrUI(line, 0, std::to_string(line).c_str());
         interface->addstrUI(". ");
-        interface->addstrUI(player_character->activePokemon.at(i)->pokemonInfo->name.c_str());
+        interface->addstrUI(player_character->activePokemon.at(i).info().getName());
         interface->addstrUI(" Level ");
-        interface->addstrUI(std::to_string(player_character->activePokemon.at(i)->level).c_str());
+        interface->addstrUI(std::to_string(player_character->activePokemon.at(i).level).c_str());
         interface->addstrUI(" ");
-        interface->addstrUI(std::to_string(player_character->activePokemon.at(i)->getHealth()).c_str());
+        interface->addstrUI(std::to_string(player_character->activePokemon.at(i).getHealth()).c_str());
         interface->addstrUI("/");
-        interface->addstrUI(std::to_string(player_character->activePokemon.at(i)->maxHealth).c_str());
+        interface->addstrUI(std::to_string(player_character->activePokemon.at(i).maxHealth).c_str());
         interface->addstrUI(" ");
         interface->addstrUI(" HP");
         line++;
@@ -3171,7 +5191,7 @@ Pokemon *switch_pokemon_action(Pokemon *selectedPokemon, bool mustSwitch) {
         const char input = interface->getchUI();
         int inputInt = input - '0';
         if (inputInt > 0 && inputInt <= player_character->activePokemon.size()) {
-            Pokemon * pokemon = player_character->activePokemon.at( inputInt- 1);
+            Pokemon * pokemon = &player_character->activePokemon.at( inputInt- 1);
             if (selectedPokemon == pokemon) {
                 int line = 0;
                 interface->clearUI();
@@ -3186,11 +5206,11 @@ Pokemon *switch_pokemon_action(Pokemon *selectedPokemon, bool mustSwitch) {
                 for (int i = 0; i < player_character->activePokemon.size(); i++) {
                     interface->mvaddstrUI(line, 0, std::to_string(line).c_str());
                     interface->addstrUI(". ");
-                    interface->addstrUI(player_character->activePokemon.at(i)->pokemonInfo->name.c_str());
+                    interface->addstrUI(player_character->activePokemon.at(i).info().getName());
                     interface->addstrUI(" Level ");
-                    interface->addstrUI(std::to_string(player_character->activePokemon.at(i)->level).c_str());
+                    interface->addstrUI(std::to_string(player_character->activePokemon.at(i).level).c_str());
                     interface->addstrUI(" ");
-                    interface->addstrUI(std::to_string(player_character->activePokemon.at(i)->getHealth()).c_str());
+                    interface->addstrUI(std::to_string(player_character->activePokemon.at(i).getHealth()).c_str());
                     interface->addstrUI(" HP");
                     line++;
                 }
@@ -3213,11 +5233,11 @@ Pokemon *switch_pokemon_action(Pokemon *selectedPokemon, bool mustSwitch) {
                 for (int i = 0; i < player_character->activePokemon.size(); i++) {
                     interface->mvaddstrUI(line, 0, std::to_string(line).c_str());
                     interface->addstrUI(". ");
-                    interface->addstrUI(player_character->activePokemon.at(i)->pokemonInfo->name.c_str());
+                    interface->addstrUI(player_character->activePokemon.at(i).info().getName());
                     interface->addstrUI(" Level ");
-                    interface->addstrUI(std::to_string(player_character->activePokemon.at(i)->level).c_str());
+                    interface->addstrUI(std::to_string(player_character->activePokemon.at(i).level).c_str());
                     interface->addstrUI(" ");
-                    interface->addstrUI(std::to_string(player_character->activePokemon.at(i)->getHealth()).c_str());
+                    interface->addstrUI(std::to_string(player_character->activePokemon.at(i).getHealth()).c_str());
                     interface->addstrUI(" HP");
                     line++;
                 }
@@ -3241,7 +5261,7 @@ Pokemon *switch_pokemon_action(Pokemon *selectedPokemon, bool mustSwitch) {
             for (int i = 0; i < player_character->activePokemon.size(); i++) {
                 interface->mvaddstrUI(line, 0, std::to_string(line).c_str());
                 interface->addstrUI(". ");
-                interface->addstrUI(player_character->activePokemon.at(i)->pokemonInfo->name.c_str());
+                interface->addstrUI(player_character->activePokemon.at(i).info().getName());
                 line++;
             }
             interface->refreshUI();
@@ -3274,9 +5294,9 @@ int bag_action(bool wildPokemonBattle, Pokemon *selectedPokemon, Pokemon *enemyP
             if (player_character->bag->usePotion(selectedPokemon) == 0) {
                 interface->clearUI();
                 interface->addstrUI("You have used a potion on ");
-                interface->addstrUI(selectedPokemon->pokemonInfo->name.c_str());
+                interface->addstrUI(selectedPokemon->info().getName());
                 interface->addstrUI("!\n");
-                interface->addstrUI(selectedPokemon->pokemonInfo->name.c_str());
+                interface->addstrUI(selectedPokemon->info().getName());
                 interface->addstrUI(" HP: ");
                 interface->addstrUI(std::to_string(selectedPokemon->getHealth()).c_str());
                 interface->addstrUI("/");
@@ -3294,9 +5314,9 @@ int bag_action(bool wildPokemonBattle, Pokemon *selectedPokemon, Pokemon *enemyP
             if (reviveUsage == 0) {
                 interface->clearUI();
                 interface->addstrUI("You have used a revive on ");
-                interface->addstrUI(selectedPokemon->pokemonInfo->name.c_str());
+                interface->addstrUI(selectedPokemon->info().getName());
                 interface->addstrUI("!\n");
-                interface->addstrUI(selectedPokemon->pokemonInfo->name.c_str());
+                interface->addstrUI(selectedPokemon->info().getName());
                 interface->addstrUI(" HP: ");
                 interface->addstrUI(std::to_string(selectedPokemon->getHealth()).c_str());
                 interface->addstrUI("/");
@@ -3354,9 +5374,9 @@ int usePokeball(bool success, Pokemon *targetPokemon) {
     player_character->bag->numPokeballs--;
     interface->clearUI();
     if (success) {
-        player_character->activePokemon.push_back(targetPokemon);
+        player_character->activePokemon.push_back(*targetPokemon);
         interface->addstrUI("You have captured ");
-        interface->addstrUI(targetPokemon->pokemonInfo->name.c_str());
+        interface->addstrUI(targetPokemon->info().getName());
         interface->addstrUI("!");
         interface->refreshUI();
         awaitInputEscape();
@@ -3364,7 +5384,7 @@ int usePokeball(bool success, Pokemon *targetPokemon) {
     }
     else {
         interface->addstrUI("You have failed capture ");
-        interface->addstrUI(targetPokemon->pokemonInfo->name.c_str());
+        interface->addstrUI(targetPokemon->info().getName());
         interface->addstrUI("!");
         interface->refreshUI();
         awaitInputEscape();
@@ -3393,32 +5413,35 @@ int run_action(Pokemon *characterPokemon, Pokemon *wildPokemon, int numAttempts)
         }
     }
 
+    BattleLog log;
+    int result = attemptRun(characterPokemon, wildPokemon, numAttempts, log);
+    renderBattleLog(log);
+
+    return result;
+
+}
+
+/*
+ * Tries to run away from wildPokemon for the numAttempts + 1 time.
+ * @return 0 if ran away, 1 if not
+ */
+int attemptRun(Pokemon *characterPokemon, Pokemon *wildPokemon, int numAttempts, BattleLog &log) {
+
     //calculate odds of escape
-    int oddsEscape = (characterPokemon->getSpeed() * 32 / ((int)(wildPokemon->getSpeed()) % 256)) + 30 * numAttempts;
-    bool succeeded = rand() % 256 < oddsEscape;
+    //speeds above 255 count as 255, so no speed divides by zero and a faster pokemon is never easier to get away from
+    int wildSpeed = std::max(1, std::min(255, wildPokemon->getSpeed()));
+    int oddsEscape = (characterPokemon->getSpeed() * 32 / wildSpeed) + 30 * numAttempts;
+    bool succeeded = random_below(256) < oddsEscape;
+    log.add(succeeded ? BATTLE_RAN_AWAY : BATTLE_RUN_FAILED, characterPokemon);
 
-    //print status message
-    if (succeeded) {
-        interface->clearUI();
-        interface->addstrUI("You successfully ran away!");
-        interface->refreshUI();
-        awaitInputEscape();
-        return 0;
-    }
-    else {
-        interface->clearUI();
-        interface->addstrUI("You were too slow to run away! Maybe you'll be able to next time!");
-        interface->refreshUI();
-        awaitInputEscape();
-        return 1;
-    }
+    return succeeded ? 0 : 1;
 
 }
 
 int levelUp(Pokemon *pokemon) {
 
     interface->clearUI();
-    interface->addstrUI(pokemon->pokemonInfo->name.c_str());
+    interface->addstrUI(pokemon->info().getName());
     interface->addstrUI(" has leveled up to level");
     interface->addstrUI(std::to_string(pokemon->level).c_str());
     interface->addstrUI("!");
@@ -3434,6 +5457,212 @@ int levelUp(Pokemon *pokemon) {
 
 }
 
+/*
+ * Reads pokemon of a party from argv, from argument up to the first that is not one, each as
+ * <pokemon id>:<level>[:<move id>,...]. Without moves a pokemon knows the last 4 level up moves it has learned.
+ * @return 0 if read, 2 if a pokemon is invalid or there is none
+ */
+int parseBattleParty(int argc, char *argv[], int &argument, Party &party) {
+
+    for (; argument < argc && !party.full(); argument++) {
+        char *field = argv[argument];
+        char *end;
+        long pokemonID = strtol(field, &end, 10);
+        if (end == field || *end != ':') {
+            break;
+        }
+        field = end + 1;
+        long level = strtol(field, &end, 10);
+        int species = pokemonIndex.speciesOf((int) pokemonID);
+        const PokemonIndexEntry *entry = species == -1 ? NULL : &pokemonIndex.entries[species];
+        if (entry == NULL || end == field || level < 1 || level > MAXIMUM_LEVEL || (*end != '\0' && *end != ':')) {
+            std::cout << "Invalid pokemon: " << argv[argument] << "\n";
+            return 2;
+        }
+        std::vector<int> moves;
+        while (*end != '\0') {
+            field = end + 1;
+            long moveID = strtol(field, &end, 10);
+            //a pokemon knows at most 4 moves
+            if (moves.size() == 4 || end == field || (*end != '\0' && *end != ',')
+                || !moveRegistry.contains((int) moveID)) {
+                std::cout << "Invalid move in: " << argv[argument] << "\n";
+                return 2;
+            }
+            moves.push_back((int) moveID);
+        }
+        if (moves.empty()) {
+            for (uint32_t i = 0; i < entry->levelUpMoveCount; i++) {
+                const LevelUpMove &move = pokemonIndex.levelUpMoves[entry->firstLevelUpMove + i];
+                if (move.level <= level && moveRegistry.contains(move.move_id)) {
+                    moves.push_back(move.move_id);
+                }
+            }
+            if (moves.size() > 4) {
+                moves.erase(moves.begin(), moves.end() - 4);
+            }
+            if (moves.empty() && moveRegistry.contains(STRUGGLE_MOVE_ID)) {
+                moves.push_back(STRUGGLE_MOVE_ID);
+            }
+        }
+        if (moves.empty()) {
+            std::cout << "No moves for: " << argv[argument] << "\n";
+            return 2;
+        }
+        party.push_back(create_pokemon_of(species, (int) level, moves));
+    }
+
+    return party.empty() ? 2 : 0;
+
+}
+
+/*
+ * Outcomes of simulated battles between two parties.
+ */
+struct BattleEstimate {
+    //won by the first party, the second, and draws
+    long results[3];
+    long turns;
+    //first turns on which the first pokemon of the first party got away from the second's
+    long escapes;
+    //by party, battles ending with its health left in each bucket
+    long health[2][HEALTH_BUCKETS];
+};
+
+/*
+ * Battles two parties against each other many times on every core and prints how they fare. Arguments:
+ * simulate <battles> <pokemon>... vs <pokemon>... [--seed <n>], pokemon as parseBattleParty reads them. Each battle
+ * draws from its own random stream keyed by the seed and its number, so results do not depend on the number of threads.
+ * Pokemon get new IVs every battle and fight as trainers do, each turn using a random move of their first pokemon
+ * still standing. The loop only copies into pokemon each thread holds, so it does not allocate.
+ * @return 0 if simulated, 2 if the arguments are invalid
+ */
+int estimateBattles(int argc, char *argv[]) {
+
+    long battles = argc >= 3 ? atol(argv[2]) : 0;
+    Party parties[2];
+    int argument = 3;
+    uint64_t seed = time(NULL);
+    bool valid = battles > 0 && parseBattleParty(argc, argv, argument, parties[0]) == 0 && argument < argc
+                 && std::string(argv[argument++]) == "vs" && parseBattleParty(argc, argv, argument, parties[1]) == 0;
+    if (valid && argument + 1 < argc && std::string(argv[argument]) == "--seed") {
+        seed = strtoull(argv[argument + 1], NULL, 10);
+        argument += 2;
+    }
+    if (!valid || argument < argc) {
+        std::cout << "Usage: simulate <battles> <pokemon>... vs <pokemon>... [--seed <n>] with up to 6 pokemon a side, "
+                     "each <pokemon id>:<level>[:<move id>,...]" << "\n";
+        return 2;
+    }
+    int levels[2][6];
+    for (int side = 0; side < 2; side++) {
+        for (int i = 0; i < parties[side].size(); i++) {
+            levels[side][i] = parties[side].at(i).level;
+        }
+    }
+
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<BattleEstimate> estimates(threads);
+    std::atomic<long> next(0);
+    auto simulate = [&](int thread) {
+        BattleEstimate &estimate = estimates[thread];
+        memset(&estimate, 0, sizeof(estimate));
+        Party party[2] = {parties[0], parties[1]};
+        int size[2] = {party[0].size(), party[1].size()};
+        for (long batch = next.fetch_add(SIMULATED_BATTLE_BATCH); batch < battles;
+             batch = next.fetch_add(SIMULATED_BATTLE_BATCH)) {
+            for (long battle = batch; battle < std::min(battles, batch + SIMULATED_BATTLE_BATCH); battle++) {
+                CounterRandom random(CounterRandom::mix(seed) + (uint64_t) battle);
+                generation_random = &random;
+                for (int side = 0; side < 2; side++) {
+                    for (int i = 0; i < size[side]; i++) {
+                        party[side].at(i).rollIVs();
+                        party[side].at(i).restore(levels[side][i]);
+                    }
+                }
+                BattleLog log;
+                if (attemptRun(&party[0].at(0), &party[1].at(0), 0, log) == 0) {
+                    estimate.escapes++;
+                }
+                int active[2] = {0, 0};
+                int turns = 0;
+                while (active[0] < size[0] && active[1] < size[1] && turns < SIMULATED_TURN_LIMIT) {
+                    Pokemon *first = &party[0].at(active[0]);
+                    Pokemon *second = &party[1].at(active[1]);
+                    int firstMove = random_below(first->moveCount);
+                    int secondMove = random_below(second->moveCount);
+                    log.clear();
+                    doCombat(first, firstMove, second, secondMove, true, log);
+                    turns++;
+                    for (int side = 0; side < 2; side++) {
+                        while (active[side] < size[side] && party[side].at(active[side]).knockedOut) {
+                            active[side]++;
+                        }
+                    }
+                }
+                estimate.results[active[1] == size[1] ? 0 : active[0] == size[0] ? 1 : 2]++;
+                estimate.turns += turns;
+                for (int side = 0; side < 2; side++) {
+                    long health = 0;
+                    long maxHealth = 0;
+                    for (int i = 0; i < size[side]; i++) {
+                        health += party[side].at(i).health;
+                        maxHealth += party[side].at(i).maxHealth;
+                    }
+                    int bucket = health == 0 ? 0 : 1 + (int) ((health * (HEALTH_BUCKETS - 1) - 1) / maxHealth);
+                    estimate.health[side][bucket]++;
+                }
+            }
+        }
+        generation_random = NULL;
+    };
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; i++) {
+        workers.push_back(std::thread(simulate, i));
+    }
+    simulate(0);
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    BattleEstimate total;
+    memset(&total, 0, sizeof(total));
+    for (const BattleEstimate &estimate : estimates) {
+        for (int i = 0; i < 3; i++) {
+            total.results[i] += estimate.results[i];
+        }
+        total.turns += estimate.turns;
+        total.escapes += estimate.escapes;
+        for (int side = 0; side < 2; side++) {
+            for (int i = 0; i < HEALTH_BUCKETS; i++) {
+                total.health[side][i] += estimate.health[side][i];
+            }
+        }
+    }
+
+    std::cout << battles << " battles in " << seconds << " s on " << threads << " threads: " << total.turns / seconds
+              << " turns/s" << "\n";
+    std::cout << "Won by the first party: " << 100.0 * total.results[0] / battles << "%, by the second: "
+              << 100.0 * total.results[1] / battles << "%, draws after " << SIMULATED_TURN_LIMIT << " turns: "
+              << 100.0 * total.results[2] / battles << "%" << "\n";
+    std::cout << "Mean turns: " << (double) total.turns / battles << "\n";
+    std::cout << "First pokemon of the first party getting away on a first try: "
+              << 100.0 * total.escapes / battles << "%" << "\n";
+    for (int side = 0; side < 2; side++) {
+        std::cout << "Health left, " << (side == 0 ? "first" : "second") << " party: 0%: "
+                  << 100.0 * total.health[side][0] / battles << "%";
+        for (int i = 1; i < HEALTH_BUCKETS; i++) {
+            std::cout << ", " << (i - 1) * 100 / (HEALTH_BUCKETS - 1) + 1 << "-" << i * 100 / (HEALTH_BUCKETS - 1)
+                      << "%: " << 100.0 * total.health[side][i] / battles << "%";
+        }
+        std::cout << "\n";
+    }
+
+    return 0;
+
+}
+
 int enter_center() {
 
     player_character->in_building = 1;
@@ -3452,83 +5681,511 @@ int enter_mart() {
     interface->addstrUI("You are in a pokemart! Unfortunately this mart is rather barren. Leave by entering \'<\'\n");
     interface->refreshUI();
 
-    return 0;
+    return 0;
+
+}
+
+/*
+ * Moves the PC to the tile at x, y, entering it on entry_x, entry_y or the nearest free cell to it. The PC takes its
+ * cell before the trainers of the tile catch up, so none of them can end up on it.
+ */
+int change_tile(int x, int y, int entry_x, int entry_y) {
+
+    //todo: RUN BUG TEST: test moving onto new Tile with large game time for trainers time being updated correctly
+    if (x >= 0 && x < WORLD_WIDTH_X && y >= 0 && y < WORLD_LENGTH_Y) {
+        prefetcher.publish(world);
+        if (!world.contains(x, y)) {
+            //only generated here when the worker has not got to it yet
+            Tile *tile = prefetcher.take(x, y);
+            world.put(x, y, tile != NULL ? tile : fresh_tile(x, y));
+        }
+        Tile *old_tile = world.get(current_tile_x, current_tile_y);
+        old_tile->set_character(player_character->x, player_character->y, NULL);
+        old_tile->player_character = NULL;
+        //fields are for cells of the PC, so they are of no use until it comes back and are not counted in tile_memory
+        old_tile->distances.release();
+        current_tile_x = x;
+        current_tile_y = y;
+        Tile *new_tile = world.get(current_tile_x, current_tile_y);
+        nearest_free_cell(new_tile, entry_x, entry_y);
+        player_character->x = entry_x;
+        player_character->y = entry_y;
+        new_tile->set_character(entry_x, entry_y, player_character);
+        //trainers of the new tile move for the time the PC was away, stepping around the cell it is on
+        catch_up_tile(new_tile, player_character->turn);
+        new_tile->player_character = (PlayerCharacter *) player_character;
+        new_tile->visited = true;
+        new_tile->scheduler.insert(player_character);
+        //the old tile may be evicted now that it is no longer current
+        world.trim(current_tile_x, current_tile_y);
+        prefetcher.request(current_tile_x, current_tile_y, world, region);
+        return 0;
+    }
+    else {
+        return 1;
+    }
+
+}
+
+/*
+ * Moves x, y to the closest cell, by rings around it, that the PC can stand on and nobody is on. Left as is if there
+ * is none.
+ * @return 0 if x, y is free, 1 otherwise
+ */
+int nearest_free_cell(const Tile *tile, int &x, int &y) {
+
+    for (int ring = 0; ring < TILE_WIDTH_X; ring++) {
+        for (int cell_y = y - ring; cell_y <= y + ring; cell_y++) {
+            for (int cell_x = x - ring; cell_x <= x + ring; cell_x++) {
+                if ((abs(cell_x - x) != ring && abs(cell_y - y) != ring) || cell_x < 1 || cell_x > TILE_WIDTH_X - 2
+                    || cell_y < 1 || cell_y > TILE_LENGTH_Y - 2) {
+                    continue;
+                }
+                if (tile->terrain_at(cell_x, cell_y).pc_weight != INT_MAX
+                    && tile->character_at(cell_x, cell_y) == NULL) {
+                    x = cell_x;
+                    y = cell_y;
+                    return 0;
+                }
+            }
+        }
+    }
+    return 1;
+
+}
+
+/*
+ * Makes the scheduler of tile hold all of its trainers at their turns. The PC is not added.
+ */
+int schedule_tile_characters(Tile *tile) {
+
+    tile->scheduler.clear();
+    for (Character *character : tile->characters) {
+        if (character->type_enum != PLAYER && character->type_enum != BOSS) {
+            tile->scheduler.insert(character);
+        }
+    }
+
+    return 0;
+
+}
+
+/*
+ * Moves the trainers of tile, which the PC is not playing on yet, in one go until none is behind turn. A cell the PC
+ * was already placed on counts as taken, so walkers step around it. Trainers that only wait while the PC is away skip
+ * straight there, and no trainer is simulated for more than the last CATCH_UP_TURNS turns since by then where a walker
+ * started no longer shows. Walkers take a step each in rounds, one type after another, rather than strictly in turn
+ * order.
+ */
+int catch_up_tile(Tile *tile, int turn) {
+
+    static const enum character_type walker_types[3] = {RANDOM_WALKER, PACER, WANDERER};
+    for (Character *character : tile->characters) {
+        if (character->turn >= turn || character->type_enum == PLAYER || character->type_enum == BOSS) {
+            continue;
+        }
+        //rivals and hikers path to the PC, which is not here, and stationary trainers never move
+        if (character->type_enum == RIVAL || character->type_enum == HIKER || character->type_enum == STATIONARY) {
+            character->turn += (turn - character->turn + MINIMUM_TURN - 1) / MINIMUM_TURN * MINIMUM_TURN;
+        }
+        else if (character->turn < turn - CATCH_UP_TURNS) {
+            character->turn = turn - CATCH_UP_TURNS;
+        }
+    }
+    WalkerBatch batches[3];
+    for (int i = 0; i < 3; i++) {
+        batches[i].gather(tile, walker_types[i]);
+    }
+    int stepped = 1;
+    while (stepped > 0) {
+        stepped = 0;
+        for (int i = 0; i < 3; i++) {
+            stepped += batches[i].step(tile, turn);
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        batches[i].scatter();
+    }
+    schedule_tile_characters(tile);
+
+    return 0;
+
+}
+
+/*
+ * Estimates the heap memory used by a tile and its trainers.
+ */
+size_t tile_memory(Tile *tile) {
+
+    size_t memory = sizeof(Tile) + tile->characters.capacity() * sizeof(Character *);
+    for (Character *character : tile->characters) {
+        if (character->type_enum != PLAYER) {
+            //pokemon are held in the character's party
+            memory += sizeof(Character) + sizeof(Bag) + character->type_string.capacity();
+        }
+    }
+
+    return memory;
+
+}
+
+struct TileRecordHeader {
+    int32_t x;
+    int32_t y;
+    int32_t north_x;
+    int32_t south_x;
+    int32_t east_y;
+    int32_t west_y;
+    //terrain is stored as (id, length) runs along rows
+    uint16_t terrainRuns;
+    uint16_t characterCount;
+};
+
+struct CharacterRecord {
+    int32_t x;
+    int32_t y;
+    int32_t type_enum;
+    int32_t color;
+    int32_t turn;
+    int32_t direction_set;
+    int32_t x_direction;
+    int32_t y_direction;
+    int32_t in_building;
+    int32_t defeated;
+    int32_t numPotions;
+    int32_t numRevives;
+    int32_t numPokeballs;
+    char printable_character;
+    uint8_t typeStringLength;
+    uint8_t pokemonCount;
+};
+
+//species data (info, base stats and types) is looked up again in pokemonIndex by id
+struct PokemonRecord {
+    int32_t pokemon_id;
+    int32_t level;
+    int32_t experience;
+    int32_t maxHealth;
+    int32_t health;
+    uint8_t ivs[6];
+    uint8_t moveCount;
+    uint8_t male;
+    uint8_t shiny;
+    uint8_t knockedOut;
+};
+
+template <typename T>
+void append_record(std::string &record, const T *values, size_t count) {
+
+    static_assert(std::is_trivially_copyable<T>::value, "tile records must be plain data");
+    record.append((const char *) values, count * sizeof(T));
+
+}
+
+template <typename T>
+bool read_record(const char *&cursor, const char *end, T *values, size_t count) {
+
+    if ((size_t) (end - cursor) < count * sizeof(T)) {
+        return false;
+    }
+    memcpy(values, cursor, count * sizeof(T));
+    cursor += count * sizeof(T);
+    return true;
+
+}
+
+/*
+ * Writes tile and the state of its trainers to record. The PC is left out since the tile it is on is never evicted.
+ */
+int write_tile_record(Tile *tile, std::string &record) {
+
+    std::vector<uint8_t> runs;
+    const uint8_t *cells = &tile->terrain[0][0];
+    for (int i = 0; i < TILE_LENGTH_Y * TILE_WIDTH_X;) {
+        int length = 1;
+        while (i + length < TILE_LENGTH_Y * TILE_WIDTH_X && length < UINT8_MAX && cells[i + length] == cells[i]) {
+            length++;
+        }
+        runs.push_back(cells[i]);
+        runs.push_back((uint8_t) length);
+        i += length;
+    }
+    std::vector<Character *> characters;
+    for (Character *character : tile->characters) {
+        if (character->type_enum != PLAYER) {
+            characters.push_back(character);
+        }
+    }
+
+    TileRecordHeader header = {tile->x, tile->y, tile->north_x, tile->south_x, tile->east_y, tile->west_y,
+                               (uint16_t) (runs.size() / 2), (uint16_t) characters.size()};
+    append_record(record, &header, 1);
+    append_record(record, runs.data(), runs.size());
+    append_record(record, &tile->border[0][0], TILE_LENGTH_Y * TILE_BORDER_WORDS);
+    for (Character *character : characters) {
+        CharacterRecord characterRecord = {character->x, character->y, character->type_enum, character->color,
+                                           character->turn, character->direction_set, character->x_direction,
+                                           character->y_direction, character->in_building, character->defeated,
+                                           character->bag->numPotions, character->bag->numRevives,
+                                           character->bag->numPokeballs, character->printable_character,
+                                           (uint8_t) character->type_string.size(),
+                                           (uint8_t) character->activePokemon.size()};
+        append_record(record, &characterRecord, 1);
+        append_record(record, character->type_string.data(), character->type_string.size());
+        for (int i = 0; i < character->activePokemon.size(); i++) {
+            const Pokemon *pokemon = &character->activePokemon.at(i);
+            PokemonRecord pokemonRecord = {pokemon->info().id, pokemon->level, pokemon->experience,
+                                           pokemon->maxHealth, pokemon->health,
+                                           {(uint8_t) pokemon->getIV(STAT_HEALTH),
+                                            (uint8_t) pokemon->getIV(STAT_ATTACK),
+                                            (uint8_t) pokemon->getIV(STAT_DEFENSE),
+                                            (uint8_t) pokemon->getIV(STAT_SPECIAL_ATTACK),
+                                            (uint8_t) pokemon->getIV(STAT_SPECIAL_DEFENSE),
+                                            (uint8_t) pokemon->getIV(STAT_SPEED)},
+                                           pokemon->moveCount, pokemon->male, pokemon->shiny, pokemon->knockedOut};
+            append_record(record, &pokemonRecord, 1);
+            append_record(record, pokemon->moves, pokemon->moveCount);
+        }
+    }
+
+    return 0;
+
+}
+
+/*
+ * @return the tile written to record by write_tile_record, or NULL if record is malformed
+ */
+Tile *read_tile_record(const char *record, size_t size) {
+
+    const char *cursor = record;
+    const char *end = record + size;
+    TileRecordHeader header;
+    if (!read_record(cursor, end, &header, 1)) {
+        return NULL;
+    }
+    Tile *tile = new Tile();
+    tile->x = header.x;
+    tile->y = header.y;
+    tile->north_x = header.north_x;
+    tile->south_x = header.south_x;
+    tile->east_y = header.east_y;
+    tile->west_y = header.west_y;
+    tile->visited = true;
+    uint8_t *cells = &tile->terrain[0][0];
+    int cell = 0;
+    bool valid = true;
+    for (int i = 0; valid && i < header.terrainRuns; i++) {
+        uint8_t run[2];
+        valid = read_record(cursor, end, run, 2) && run[0] < TERRAIN_TYPES
+                && cell + run[1] <= TILE_LENGTH_Y * TILE_WIDTH_X;
+        for (int j = 0; valid && j < run[1]; j++) {
+            cells[cell++] = run[0];
+        }
+    }
+    valid = valid && cell == TILE_LENGTH_Y * TILE_WIDTH_X
+            && read_record(cursor, end, &tile->border[0][0], TILE_LENGTH_Y * TILE_BORDER_WORDS);
+    for (int i = 0; valid && i < header.characterCount; i++) {
+        CharacterRecord characterRecord;
+        std::string type_string;
+        valid = read_record(cursor, end, &characterRecord, 1);
+        if (valid) {
+            type_string.resize(characterRecord.typeStringLength);
+            valid = read_record(cursor, end, &type_string[0], type_string.size())
+                    && characterRecord.x >= 0 && characterRecord.x < TILE_WIDTH_X
+                    && characterRecord.y >= 0 && characterRecord.y < TILE_LENGTH_Y;
+        }
+        if (!valid) {
+            break;
+        }
+        Character *character = new Character(characterRecord.x, characterRecord.y,
+                                             (enum character_type) characterRecord.type_enum, type_string,
+                                             characterRecord.printable_character, characterRecord.color,
+                                             characterRecord.turn, characterRecord.direction_set,
+                                             characterRecord.x_direction, characterRecord.y_direction,
+                                             characterRecord.in_building, characterRecord.defeated,
+                                             new Bag(characterRecord.numPotions, characterRecord.numRevives,
+                                                     characterRecord.numPokeballs));
+        tile->set_character(character->x, character->y, character);
+        for (int j = 0; valid && j < characterRecord.pokemonCount; j++) {
+            PokemonRecord pokemonRecord;
+            valid = read_record(cursor, end, &pokemonRecord, 1);
+            std::vector<uint16_t> moves(valid ? pokemonRecord.moveCount : 0);
+            int species = valid ? pokemonIndex.speciesOf(pokemonRecord.pokemon_id) : -1;
+            valid = valid && species != -1 && read_record(cursor, end, moves.data(), moves.size());
+            if (valid) {
+                valid = character->activePokemon.push_back(
+                        Pokemon(species, pokemonRecord.level, std::vector<int>(moves.begin(), moves.end()),
+                                pokemonRecord.male, pokemonRecord.shiny, Pokemon::packIVs(pokemonRecord.ivs),
+                                pokemonRecord.experience, pokemonRecord.maxHealth, pokemonRecord.health,
+                                pokemonRecord.knockedOut));
+            }
+        }
+    }
+    if (!valid || cursor != end) {
+        delete_tile(tile);
+        return NULL;
+    }
+    tile->update_passable();
+    schedule_tile_characters(tile);
+
+    return tile;
+
+}
+
+/*
+ * Frees tile along with its trainers. The PC is left alone.
+ */
+int delete_tile(Tile *tile) {
+
+    for (Character *character : tile->characters) {
+        if (character->type_enum != PLAYER) {
+            delete character->bag;
+            delete character;
+        }
+    }
+    delete tile;
+
+    return 0;
+
+}
+
+/*
+ * @return a new tile at x, y as it is before the PC has been there, paged in from the region file if it has the tile
+ */
+Tile *fresh_tile(int x, int y) {
+
+    Tile *tile = region.read(x, y);
+    if (tile == NULL) {
+        tile = new Tile(create_tile(x, y));
+    }
 
-}
+    return tile;
 
-int change_tile(int x, int y) {
+}
 
-    //todo: BUG: remove trainers and add new trainers with time = player time to heap upon changing tile. Code is currently commented in change_tile function.
-    //todo: RUN BUG TEST: test moving onto new Tile with large game time for trainers time being updated correctly
-    if (x >= 0 && x < WORLD_WIDTH_X && y >= 0 && y < WORLD_LENGTH_Y) {
-        if (world[y][x] == NULL) {
-            Tile *new_tile = new Tile();
-            *new_tile = create_tile(x, y);
-            world[y][x] = new_tile;
-        }
-        world[current_tile_y][current_tile_x]->player_character = NULL;
-        current_tile_x = x;
-        current_tile_y = y;
-        Tile *new_tile = world[current_tile_y][current_tile_x];
-        new_tile->player_character = (PlayerCharacter *) player_character;
-        //set all characters in heap to same turn value as PC
-        //todo: RUN BUG: moving between tiles sometimes crashes
-        //todo: RUN BUG: upon re-entering ORIGINAL map (but not other maps) post leaving it, trainers never move
-        //todo: RUN BUG TEST: uncomment below once heap crash insert bug fixed
-//        if (new_tile->turn_heap->size > 0) {
-//            NonPlayerCharacter *trainer = heap_remove_min(new_tile->turn_heap);
-//            while (trainer->turn < player_character->turn) {
-//                trainer->turn = player_character->turn;
-//                heap_insert(new_tile->turn_heap, trainer);
-//                trainer = heap_remove_min(new_tile->turn_heap);
-//            }
-//        }
-        heap_insert(&turn_heap, player_character);
-        return 0;
+/*
+ * Generates a rectangle of the world on every core and writes it to a region file the game can page tiles in from
+ * with --region. Arguments: pregenerate <file> [<x0> <y0> <x1> <y1>] [--seed <n>], all of the world by default.
+ * @return 0 if written, 1 if the file could not be written, 2 if the arguments are invalid
+ */
+int pregenerate_region(int argc, char *argv[]) {
+
+    if (argc < 3) {
+        std::cout << "No region file provided." << "\n";
+        return 2;
+    }
+    const char *fileName = argv[2];
+    RegionFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, REGION_FILE_MAGIC, sizeof(header.magic));
+    header.version = REGION_FILE_VERSION;
+    header.num_trainers = num_trainers;
+    header.x0 = 0;
+    header.y0 = 0;
+    header.x1 = WORLD_WIDTH_X - 1;
+    header.y1 = WORLD_LENGTH_Y - 1;
+    world_seed = time(NULL);
+    int argument = 3;
+    if (argc >= 7 && std::string(argv[3]) != "--seed") {
+        header.x0 = atoi(argv[3]);
+        header.y0 = atoi(argv[4]);
+        header.x1 = atoi(argv[5]);
+        header.y1 = atoi(argv[6]);
+        argument = 7;
+    }
+    if (argument + 1 < argc && std::string(argv[argument]) == "--seed") {
+        world_seed = strtoull(argv[argument + 1], NULL, 10);
+        argument += 2;
+    }
+    if (argument < argc || header.x0 < 0 || header.x0 > header.x1 || header.x1 >= WORLD_WIDTH_X || header.y0 < 0
+        || header.y0 > header.y1 || header.y1 >= WORLD_LENGTH_Y) {
+        std::cout << "Invalid region. Usage: pregenerate <file> [<x0> <y0> <x1> <y1>] [--seed <n>] with 0 <= x0 <= x1 < "
+                  << WORLD_WIDTH_X << " and 0 <= y0 <= y1 < " << WORLD_LENGTH_Y << "\n";
+        return 2;
+    }
+    header.world_seed = world_seed;
+    header.growth_mode = growth_mode;
+    int width = header.x1 - header.x0 + 1;
+    int tiles = width * (header.y1 - header.y0 + 1);
+
+    //write next to the region file and rename over it so a game never maps a partly written file
+    std::string temporaryPath = std::string(fileName) + ".tmp";
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cout << "Region file not written successfully. File: " << fileName << "\n";
+        return 1;
     }
-    else {
+    std::vector<RegionTileEntry> entries(tiles);
+    uint64_t offset = sizeof(header) + entries.size() * sizeof(RegionTileEntry);
+    file.seekp(offset);
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<std::string> records(REGION_BATCH_SIZE);
+    for (int batch = 0; batch < tiles; batch += REGION_BATCH_SIZE) {
+        int batchSize = std::min(REGION_BATCH_SIZE, tiles - batch);
+        std::atomic<int> next(0);
+        auto generate = [&next, &records, &header, batch, batchSize, width]() {
+            for (int i = next++; i < batchSize; i = next++) {
+                Tile *tile = new Tile(create_tile(header.x0 + (batch + i) % width, header.y0 + (batch + i) / width));
+                records[i].clear();
+                write_tile_record(tile, records[i]);
+                delete_tile(tile);
+            }
+        };
+        std::vector<std::thread> workers;
+        for (int i = 1; i < threads; i++) {
+            workers.push_back(std::thread(generate));
+        }
+        generate();
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        for (int i = 0; i < batchSize; i++) {
+            entries[batch + i].offset = offset;
+            entries[batch + i].size = records[i].size();
+            file.write(records[i].data(), records[i].size());
+            offset += records[i].size();
+        }
+    }
+    file.seekp(0);
+    file.write((const char *) &header, sizeof(header));
+    file.write((const char *) entries.data(), entries.size() * sizeof(RegionTileEntry));
+    file.close();
+    if (!file || rename(temporaryPath.c_str(), fileName) != 0) {
+        remove(temporaryPath.c_str());
+        std::cout << "Region file not written successfully. File: " << fileName << "\n";
         return 1;
     }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Region file written. File: " << fileName << ", " << tiles << " tiles (" << header.x0 << "," << header.y0
+              << ")-(" << header.x1 << "," << header.y1 << "), seed " << world_seed << ", " << offset / 1024
+              << " KB, " << tiles / seconds << " tiles/s on " << threads << " threads" << "\n";
+
+    return 0;
 
 }
 
 Tile create_tile(int x, int y) {
 
+    //every draw comes from the tile's own stream so the same tile is generated whatever order tiles are visited in
+    CounterRandom random(tile_random_key(x, y, 0));
+    CounterRandom *previous_random = generation_random;
+    generation_random = &random;
     Tile tile = create_empty_tile();
     tile.x = x;
     tile.y = y;
     generate_terrain(&tile);
-    int north_x;
-    if (y > 0 && world[y - 1][x] != NULL) {
-        //north_x = world[y - 1][x]->south_x;
-    }
-    else {
-        north_x = rand() % (TILE_WIDTH_X - 10) + 5;
-    }
-    int south_x;
-    if (y < WORLD_LENGTH_Y - 1 && world[y + 1][x] != NULL) {
-        //south_x = world[y + 1][x]->north_x;
-    }
-    else {
-        south_x = rand() % (TILE_WIDTH_X - 10) + 5;
-    }
-    int east_y;
-    if (x < WORLD_WIDTH_X - 1 && world[y][x + 1] != NULL) {
-        //east_y = world[y][x + 1]->west_y;
-    }
-    else {
-        east_y = rand() % (TILE_LENGTH_Y - 10) + 5;
-    }
-    int west_y;
-    if (x > 0 && world[y][x - 1] != NULL) {
-        //west_y = world[y][x - 1]->east_y;
-    }
-    else {
-        west_y = rand() % (TILE_LENGTH_Y - 10) + 5;
-    }
+    //gates are drawn from the stream of the edge they are on so neighboring tiles agree on them
+    int north_x = CounterRandom(tile_random_key(x, y - 1, 1)).below(TILE_WIDTH_X - 10) + 5;
+    int south_x = CounterRandom(tile_random_key(x, y, 1)).below(TILE_WIDTH_X - 10) + 5;
+    int east_y = CounterRandom(tile_random_key(x, y, 2)).below(TILE_LENGTH_Y - 10) + 5;
+    int west_y = CounterRandom(tile_random_key(x - 1, y, 2)).below(TILE_LENGTH_Y - 10) + 5;
     generate_paths(&tile, north_x, south_x, east_y, west_y);
     generate_buildings(&tile, x, y);
+    tile.update_passable();
     place_trainers(&tile);
+    schedule_tile_characters(&tile);
+    generation_random = previous_random;
     return tile;
 
 }
@@ -3536,14 +6193,6 @@ Tile create_tile(int x, int y) {
 Tile create_empty_tile() {
 
     Tile tile;
-    Point *empty_point = new Point();
-    for (int i = 0; i < TILE_LENGTH_Y; i++) {
-        for (int j = 0; j < TILE_WIDTH_X; j++) {
-            tile.tile[i][j] = *empty_point;
-            tile.tile[i][j].x = j;
-            tile.tile[i][j].y = i;
-        }
-    }
     tile.north_x = -1;
     tile.south_x = -1;
     tile.east_y = -1;
@@ -3554,16 +6203,16 @@ Tile create_empty_tile() {
 
 int generate_terrain(Tile *tile) {
 
-    const int NUM_TALL_GRASS_SEEDS = rand() % 5 + 2;
-    const int NUM_CLEARING_SEEDS = rand() % 5 + 2;
-    const int NUM_FOREST_SEEDS = rand() % 5;
-    const int NUM_MOUNTAIN_SEEDS = rand() % 4;
-    const int NUM_LAKE_SEEDS = rand() % 3;
-    plant_seeds(tile, *grass, NUM_TALL_GRASS_SEEDS);
-    plant_seeds(tile, *clearing, NUM_CLEARING_SEEDS);
-    plant_seeds(tile, *forest, NUM_FOREST_SEEDS);
-    plant_seeds(tile, *mountain, NUM_MOUNTAIN_SEEDS);
-    plant_seeds(tile, *lake, NUM_LAKE_SEEDS);
+    const int NUM_TALL_GRASS_SEEDS = random_below(5) + 2;
+    const int NUM_CLEARING_SEEDS = random_below(5) + 2;
+    const int NUM_FOREST_SEEDS = random_below(5);
+    const int NUM_MOUNTAIN_SEEDS = random_below(4);
+    const int NUM_LAKE_SEEDS = random_below(3);
+    plant_seeds(tile, grass->id, NUM_TALL_GRASS_SEEDS);
+    plant_seeds(tile, clearing->id, NUM_CLEARING_SEEDS);
+    plant_seeds(tile, forest->id, NUM_FOREST_SEEDS);
+    plant_seeds(tile, mountain->id, NUM_MOUNTAIN_SEEDS);
+    plant_seeds(tile, lake->id, NUM_LAKE_SEEDS);
     grow_seeds(tile);
     place_edge(tile);
     set_terrain_border_weights(tile);
@@ -3572,15 +6221,15 @@ int generate_terrain(Tile *tile) {
 
 }
 
-int plant_seeds(Tile *tile, Terrain terrain, int num_seeds) {
+int plant_seeds(Tile *tile, int terrain, int num_seeds) {
 
     for (int i = 0; i < num_seeds; i++) {
         int placed = 0;
         while (placed == 0) {
-            int x = rand() % (TILE_WIDTH_X - 2) + 1;
-            int y = rand() % (TILE_LENGTH_Y - 2) + 1;
-            if (tile->tile[y][x].terrain.id == none->id) {
-                tile->tile[y][x].terrain = terrain;
+            int x = random_below(TILE_WIDTH_X - 2) + 1;
+            int y = random_below(TILE_LENGTH_Y - 2) + 1;
+            if (tile->terrain[y][x] == none->id) {
+                tile->terrain[y][x] = terrain;
                 placed = 1;
             }
         }
@@ -3592,16 +6241,88 @@ int plant_seeds(Tile *tile, Terrain terrain, int num_seeds) {
 
 int grow_seeds(Tile *tile) {
 
-    //queue implementation:
-    //add each (coordinate, Terrain) tuple structure to queue
-    //while queue not empty
-    //pop
-    //if does not have Terrain
-    //give Terrain as specified in tuple
-    //give space weight value for dijkstra (as defined earlier)
-    //add all spaces within 3x and 1y to queue with same Terrain
+    //multi source breadth first growth: a cell is looked at once, the round after a neighbor of it gets terrain,
+    //instead of once per round of full grid scans
+    const int interior = (TILE_LENGTH_Y - 2) * (TILE_WIDTH_X - 2);
+    uint16_t frontier[interior];
+    uint16_t reached[interior];
+    uint8_t grow_into[interior];
+    uint8_t seen[TILE_LENGTH_Y][TILE_WIDTH_X];
+    memset(seen, 0, sizeof(seen));
+    int frontier_size = 0;
+    for (int i = 1; i < TILE_LENGTH_Y - 1; i++) {
+        for (int j = 1; j < TILE_WIDTH_X - 1; j++) {
+            if (tile->terrain[i][j] != none->id) {
+                seen[i][j] = 1;
+                frontier[frontier_size++] = (uint16_t) (i * TILE_WIDTH_X + j);
+            }
+        }
+    }
+    while (frontier_size > 0) {
+        //cells reached this round, all of which grow at once so none of them sees another's new terrain
+        int reached_size = 0;
+        for (int f = 0; f < frontier_size; f++) {
+            int i = frontier[f] / TILE_WIDTH_X;
+            int j = frontier[f] % TILE_WIDTH_X;
+            for (int l = -1; l <= 1; l++) {
+                for (int k = -1; k <= 1; k++) {
+                    int x = j + k;
+                    int y = i + l;
+                    if (x > 0 && x < TILE_WIDTH_X - 1 && y > 0 && y < TILE_LENGTH_Y - 1 && seen[y][x] == 0) {
+                        seen[y][x] = 1;
+                        grow_into[reached_size] = tile->terrain[i][j];
+                        reached[reached_size++] = (uint16_t) (y * TILE_WIDTH_X + x);
+                    }
+                }
+            }
+        }
+        if (growth_mode == GROWTH_NEIGHBOR_SCAN) {
+            for (int r = 0; r < reached_size; r++) {
+                grow_into[r] = neighbor_scan_terrain(tile, reached[r] % TILE_WIDTH_X, reached[r] / TILE_WIDTH_X);
+            }
+        }
+        for (int r = 0; r < reached_size; r++) {
+            tile->terrain[reached[r] / TILE_WIDTH_X][reached[r] % TILE_WIDTH_X] = grow_into[r];
+        }
+        memcpy(frontier, reached, reached_size * sizeof(uint16_t));
+        frontier_size = reached_size;
+    }
+
+    return 0;
+
+}
+
+/*
+ * @return the terrain the original grow_seeds loop gave the cell at x, y: the last one found scanning its neighbors a
+ * column at a time
+ */
+uint8_t neighbor_scan_terrain(Tile *tile, int x, int y) {
+
+    uint8_t terrain = none->id;
+    for (int k = -1; k <= 1; k++) {
+        for (int l = -1; l <= 1; l++) {
+            int neighbor_x = x + k;
+            int neighbor_y = y + l;
+            if (neighbor_x > 0 && neighbor_x < TILE_WIDTH_X - 1 && neighbor_y > 0 && neighbor_y < TILE_LENGTH_Y - 1
+                && tile->terrain[neighbor_y][neighbor_x] != none->id) {
+                terrain = tile->terrain[neighbor_y][neighbor_x];
+            }
+        }
+    }
+
+    return terrain;
+
+}
+
+/*
+ * The original grow_seeds, which repeats full grid passes until no cell is left without terrain. Kept to benchmark
+ * against.
+ */
+int grow_seeds_fixed_point(Tile *tile) {
 
     //loop through non-edge to grow seeds
+    uint8_t grow_into[TILE_LENGTH_Y][TILE_WIDTH_X];
+    memset(grow_into, none->id, sizeof(grow_into));
     int complete = 0;
     while (complete == 0) {
         //if no changes made in a loop then no more loops required
@@ -3609,16 +6330,16 @@ int grow_seeds(Tile *tile) {
         //determine what must grow
         for (int i = 1; i < TILE_LENGTH_Y - 1; i++) {
             for (int j = 1; j < TILE_WIDTH_X - 1; j++) {
-                if (tile->tile[i][j].terrain.id == none->id) {
+                if (tile->terrain[i][j] == none->id) {
                     //loop through nearby area to copy first Terrain found
                     for (int k = -1; k <=1; k++) {
                         for (int l = -1; l <= 1; l++) {
                             int x = j+k;
                             int y = i+l;
                             if (x > 0 && x < TILE_WIDTH_X - 1 && y > 0 && y < TILE_LENGTH_Y - 1) {
-                                Terrain new_terrain = tile->tile[y][x].terrain;
-                                if (new_terrain.id != none->id) {
-                                    tile->tile[i][j].grow_into = new_terrain;
+                                uint8_t new_terrain = tile->terrain[y][x];
+                                if (new_terrain != none->id) {
+                                    grow_into[i][j] = new_terrain;
                                 }
                             }
                         }
@@ -3630,9 +6351,9 @@ int grow_seeds(Tile *tile) {
         //grow what must grow
         for (int i = 1; i < TILE_LENGTH_Y - 1; i++) {
             for (int j = 1; j < TILE_WIDTH_X - 1; j++) {
-                Terrain new_terrain = tile->tile[i][j].grow_into;
-                if (new_terrain.id != none->id) {
-                    tile->tile[i][j].terrain = new_terrain;
+                uint8_t new_terrain = grow_into[i][j];
+                if (new_terrain != none->id) {
+                    tile->terrain[i][j] = new_terrain;
                 }
             }
         }
@@ -3642,16 +6363,714 @@ int grow_seeds(Tile *tile) {
 
 }
 
+/*
+ * Times growing the same seeded tiles with grow_seeds_fixed_point and with grow_seeds in both growth modes, and checks
+ * that grow_seeds in GROWTH_NEIGHBOR_SCAN makes the same tiles as the original loop.
+ */
+int benchmark_grow_seeds(int num_tiles) {
+
+    std::vector<Tile> seeded(num_tiles);
+    for (int i = 0; i < num_tiles; i++) {
+        CounterRandom random(tile_random_key(i % WORLD_WIDTH_X, i / WORLD_WIDTH_X, 0));
+        generation_random = &random;
+        plant_seeds(&seeded[i], grass->id, random_below(5) + 2);
+        plant_seeds(&seeded[i], clearing->id, random_below(5) + 2);
+        plant_seeds(&seeded[i], forest->id, random_below(5));
+        plant_seeds(&seeded[i], mountain->id, random_below(4));
+        plant_seeds(&seeded[i], lake->id, random_below(3));
+        generation_random = NULL;
+    }
+    enum growth_mode previous_mode = growth_mode;
+    std::vector<Tile> fixed_point = seeded;
+    std::vector<Tile> neighbor_scan = seeded;
+    std::vector<Tile> first_reached = seeded;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (Tile &tile : fixed_point) {
+        grow_seeds_fixed_point(&tile);
+    }
+    double fixed_point_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    growth_mode = GROWTH_NEIGHBOR_SCAN;
+    start = std::chrono::steady_clock::now();
+    for (Tile &tile : neighbor_scan) {
+        grow_seeds(&tile);
+    }
+    double neighbor_scan_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    growth_mode = GROWTH_FIRST_REACHED;
+    start = std::chrono::steady_clock::now();
+    for (Tile &tile : first_reached) {
+        grow_seeds(&tile);
+    }
+    double first_reached_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    growth_mode = previous_mode;
+
+    int differing = 0;
+    for (int i = 0; i < num_tiles; i++) {
+        if (memcmp(fixed_point[i].terrain, neighbor_scan[i].terrain, sizeof(fixed_point[i].terrain)) != 0) {
+            differing++;
+        }
+    }
+    std::cout << "grow_seeds on " << num_tiles << " tiles: fixed point loop " << num_tiles / fixed_point_seconds
+              << " tiles/s, frontier (neighbor scan) " << num_tiles / neighbor_scan_seconds << " tiles/s "
+              << fixed_point_seconds / neighbor_scan_seconds << "x, frontier (first reached) "
+              << num_tiles / first_reached_seconds << " tiles/s " << fixed_point_seconds / first_reached_seconds
+              << "x" << "\n";
+    std::cout << "Tiles differing between the fixed point loop and neighbor scan growth: " << differing << "\n";
+
+    return differing == 0 ? 0 : 1;
+
+}
+
+/*
+ * Takes num_turns turns of num_characters characters, each moving again MINIMUM_TURN to 15 turns later like trainers
+ * crossing terrain, through a binary heap, the Fibonacci heap of heap.c and the turn scheduler.
+ */
+int benchmark_turns(int num_characters, int num_turns) {
+
+    std::vector<Character *> characters;
+    std::vector<int> first_turns(num_characters);
+    std::vector<int> steps(num_turns);
+    srand(1);
+    for (int i = 0; i < num_characters; i++) {
+        first_turns[i] = rand() % 16;
+    }
+    for (int i = 0; i < num_turns; i++) {
+        steps[i] = MINIMUM_TURN + rand() % (16 - MINIMUM_TURN);
+    }
+    for (int i = 0; i < num_characters; i++) {
+        characters.push_back(new Character(0, 0, WANDERER, "wanderer", 'w', COLOR_RED, first_turns[i], 0, 0, 0, 0, 0));
+    }
+
+    //lowest turn on top
+    auto later = [](const Character *a, const Character *b) { return a->turn > b->turn; };
+    std::priority_queue<Character *, std::vector<Character *>, decltype(later)> heap(later);
+    for (Character *character : characters) {
+        heap.push(character);
+    }
+    int64_t heap_checksum = 0;
+    int last_turn = INT_MIN;
+    bool ordered = true;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_turns; i++) {
+        Character *character = heap.top();
+        heap.pop();
+        ordered = ordered && character->turn >= last_turn;
+        last_turn = character->turn;
+        heap_checksum += character->turn;
+        character->turn += steps[i];
+        heap.push(character);
+    }
+    double heap_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (int i = 0; i < num_characters; i++) {
+        characters[i]->turn = first_turns[i];
+    }
+    heap_t fibonacci_heap;
+    heap_init(&fibonacci_heap, comparator_character_movement, NULL);
+    for (Character *character : characters) {
+        heap_insert(&fibonacci_heap, character);
+    }
+    int64_t fibonacci_checksum = 0;
+    last_turn = INT_MIN;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_turns; i++) {
+        Character *character = (Character *) heap_remove_min(&fibonacci_heap);
+        ordered = ordered && character->turn >= last_turn;
+        last_turn = character->turn;
+        fibonacci_checksum += character->turn;
+        character->turn += steps[i];
+        heap_insert(&fibonacci_heap, character);
+    }
+    double fibonacci_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    heap_delete(&fibonacci_heap);
+
+    for (int i = 0; i < num_characters; i++) {
+        characters[i]->turn = first_turns[i];
+    }
+    TurnScheduler scheduler;
+    for (Character *character : characters) {
+        scheduler.insert(character);
+    }
+    int64_t scheduler_checksum = 0;
+    last_turn = INT_MIN;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_turns; i++) {
+        Character *character = scheduler.pop();
+        ordered = ordered && character->turn >= last_turn;
+        last_turn = character->turn;
+        scheduler_checksum += character->turn;
+        character->turn += steps[i];
+        scheduler.insert(character);
+    }
+    double scheduler_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (Character *character : characters) {
+        delete character->bag;
+        delete character;
+    }
+    std::cout << num_turns << " turns of " << num_characters << " characters: heap " << num_turns / heap_seconds
+              << " turns/s, Fibonacci heap " << num_turns / fibonacci_seconds << " turns/s, turn scheduler "
+              << num_turns / scheduler_seconds << " turns/s " << heap_seconds / scheduler_seconds << "x" << "\n";
+    //ties may go in another order, but the turns taken add up the same when all always take the lowest
+    bool agree = heap_checksum == fibonacci_checksum && heap_checksum == scheduler_checksum;
+    std::cout << "Turns taken in order: " << (ordered && agree ? "yes" : "no") << "\n";
+
+    return ordered && agree ? 0 : 1;
+
+}
+
+/*
+ * Inserts num_keys random keys into the Fibonacci heap of heap.c, decreases each once and removes them all, rounds
+ * times, and prints the throughput of each operation.
+ */
+int benchmark_heap(int num_keys, int rounds) {
+
+    std::vector<int> keys(num_keys);
+    std::vector<heap_node_t *> nodes(num_keys);
+    auto compare = [](const void *key, const void *with) -> int32_t {
+        return *(const int *) key - *(const int *) with;
+    };
+    double insert_seconds = 0;
+    double decrease_seconds = 0;
+    double remove_seconds = 0;
+    bool ordered = true;
+    srand(1);
+    for (int round = 0; round < rounds; round++) {
+        heap_t heap;
+        heap_init(&heap, compare, NULL);
+        for (int i = 0; i < num_keys; i++) {
+            keys[i] = rand() % (num_keys * 4) + num_keys;
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_keys; i++) {
+            nodes[i] = heap_insert(&heap, &keys[i]);
+        }
+        insert_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        //once first so decrease keys find nodes in trees rather than all in the root list
+        int last_key = *(int *) heap_remove_min(&heap);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_keys; i++) {
+            if (keys[i] > last_key) {
+                keys[i] -= rand() % (keys[i] - last_key);
+                heap_decrease_key_no_replace(&heap, nodes[i]);
+            }
+        }
+        decrease_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        for (int i = 1; i < num_keys; i++) {
+            int key = *(int *) heap_remove_min(&heap);
+            ordered = ordered && key >= last_key;
+            last_key = key;
+        }
+        remove_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ordered = ordered && heap_peek_min(&heap) == NULL;
+        heap_delete(&heap);
+    }
+    double operations = (double) num_keys * rounds;
+    std::cout << "Fibonacci heap of " << num_keys << " keys: insert " << operations / insert_seconds
+              << " /s, decrease key " << operations / decrease_seconds << " /s, remove min "
+              << operations / remove_seconds << " /s" << "\n";
+    std::cout << "Keys removed in order: " << (ordered ? "yes" : "no") << "\n";
+
+    return ordered ? 0 : 1;
+
+}
+
+/*
+ * @return num_tiles tiles around the center of the world, 20 to a row, with terrain only and no trainers
+ */
+std::vector<Tile *> create_trainerless_tiles(int num_tiles) {
+
+    int previous_num_trainers = num_trainers;
+    num_trainers = 0;
+    std::vector<Tile *> tiles;
+    for (int i = 0; i < num_tiles; i++) {
+        tiles.push_back(new Tile(create_tile(WORLD_CENTER_X + i % 20, WORLD_CENTER_Y + i / 20)));
+    }
+    num_trainers = previous_num_trainers;
+
+    return tiles;
+
+}
+
+/*
+ * Sets x and y to a random path cell of tile, away from its edge.
+ */
+void random_path_cell(const Tile *tile, int &x, int &y) {
+
+    do {
+        x = rand() % (TILE_WIDTH_X - 2) + 1;
+        y = rand() % (TILE_LENGTH_Y - 2) + 1;
+    } while (tile->terrain[y][x] != path->id);
+
+}
+
+/*
+ * Sets new_x and new_y to a random neighbor of x, y on tile the PC can step onto, away from the tile's edge.
+ */
+void random_pc_step(const Tile *tile, int x, int y, int &new_x, int &new_y) {
+
+    do {
+        int direction = rand() % 8;
+        new_x = x + direction_x[direction];
+        new_y = y + direction_y[direction];
+    } while (new_x < 1 || new_x > TILE_WIDTH_X - 2 || new_y < 1 || new_y > TILE_LENGTH_Y - 2
+             || tile->terrain_at(new_x, new_y).pc_weight == INT_MAX);
+
+}
+
+/*
+ * Takes num_turns turns of characters, in turn order as long as pop gives the one with the lowest turn, each moving
+ * again steps[i] turns later.
+ *
+ * @return seconds taken
+ */
+template <typename Push, typename Pop>
+double time_turns(std::vector<Character *> &characters, const std::vector<int> &first_turns,
+                  const std::vector<int> &steps, Push push, Pop pop, int64_t &checksum, bool &ordered) {
+
+    for (size_t i = 0; i < characters.size(); i++) {
+        characters[i]->turn = first_turns[i];
+        push(characters[i]);
+    }
+    checksum = 0;
+    int last_turn = INT_MIN;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < steps.size(); i++) {
+        Character *character = pop();
+        ordered = ordered && character->turn >= last_turn;
+        last_turn = character->turn;
+        checksum += character->turn;
+        character->turn += steps[i];
+        push(character);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (size_t i = 0; i < characters.size(); i++) {
+        pop();
+    }
+
+    return seconds;
+
+}
+
+/*
+ * Runs the two workloads of the game a priority queue could serve through heap.c and the queues of priority_queue.h:
+ * num_turns turns of num_characters characters, and rival and hiker distance fields (Dijkstra with decrease key) for
+ * cells of num_tiles tiles, checked against distance_field.
+ */
+int benchmark_queues(int num_tiles, int num_characters, int num_turns) {
+
+    std::vector<Character *> characters;
+    std::vector<int> first_turns(num_characters);
+    std::vector<int> steps(num_turns);
+    srand(1);
+    for (int i = 0; i < num_characters; i++) {
+        first_turns[i] = rand() % 16;
+    }
+    for (int i = 0; i < num_turns; i++) {
+        steps[i] = MINIMUM_TURN + rand() % (16 - MINIMUM_TURN);
+    }
+    for (int i = 0; i < num_characters; i++) {
+        characters.push_back(new Character(0, 0, WANDERER, "wanderer", 'w', COLOR_RED, 0, 0, 0, 0, 0, 0));
+    }
+    auto earlier = [](const Character *a, const Character *b) { return a->turn < b->turn; };
+    bool ordered = true;
+    int64_t checksums[4];
+    double turn_seconds[4];
+
+    heap_t fibonacci_heap;
+    heap_init(&fibonacci_heap, comparator_character_movement, NULL);
+    turn_seconds[0] = time_turns(characters, first_turns, steps,
+                                 [&](Character *character) { heap_insert(&fibonacci_heap, character); },
+                                 [&]() { return (Character *) heap_remove_min(&fibonacci_heap); },
+                                 checksums[0], ordered);
+    heap_delete(&fibonacci_heap);
+    BinaryHeap<Character *, decltype(earlier)> binary_heap(earlier);
+    turn_seconds[1] = time_turns(characters, first_turns, steps,
+                                 [&](Character *character) { binary_heap.push(character); },
+                                 [&]() { return binary_heap.pop(); }, checksums[1], ordered);
+    DaryHeap<Character *, decltype(earlier)> dary_heap(earlier);
+    turn_seconds[2] = time_turns(characters, first_turns, steps,
+                                 [&](Character *character) { dary_heap.push(character); },
+                                 [&]() { return dary_heap.pop(); }, checksums[2], ordered);
+    PairingHeap<Character *, decltype(earlier)> pairing_heap(earlier);
+    turn_seconds[3] = time_turns(characters, first_turns, steps,
+                                 [&](Character *character) { pairing_heap.push(character); },
+                                 [&]() { return pairing_heap.pop(); }, checksums[3], ordered);
+    for (Character *character : characters) {
+        delete character->bag;
+        delete character;
+    }
+    bool agree = checksums[0] == checksums[1] && checksums[0] == checksums[2] && checksums[0] == checksums[3];
+    std::cout << num_turns << " turns of " << num_characters << " characters: heap.c " << num_turns / turn_seconds[0]
+              << " turns/s, binary heap " << num_turns / turn_seconds[1] << " turns/s, 4-ary heap "
+              << num_turns / turn_seconds[2] << " turns/s, pairing heap " << num_turns / turn_seconds[3] << " turns/s"
+              << "\n";
+    std::cout << "Turns taken in order: " << (ordered && agree ? "yes" : "no") << "\n";
+
+    std::vector<Tile *> tiles = create_trainerless_tiles(num_tiles);
+
+    const int cells = TILE_LENGTH_Y * TILE_WIDTH_X;
+    struct Cell {
+        int distance;
+        int index;
+    };
+    static Cell distances[TILE_LENGTH_Y * TILE_WIDTH_X];
+    static int weights[TILE_LENGTH_Y * TILE_WIDTH_X];
+    static int expected[TILE_LENGTH_Y][TILE_WIDTH_X];
+    static heap_node_t *fibonacci_nodes[TILE_LENGTH_Y * TILE_WIDTH_X];
+    typedef PairingHeap<std::pair<int, int>> CellPairingHeap;
+    static CellPairingHeap::Node *pairing_nodes[TILE_LENGTH_Y * TILE_WIDTH_X];
+    auto compare_cells = [](const void *key, const void *with) -> int32_t {
+        return ((const Cell *) key)->distance - ((const Cell *) with)->distance;
+    };
+    IndexedHeap<int> indexed_heap(cells);
+    CellPairingHeap cell_pairing_heap;
+    double field_seconds[4] = {0, 0, 0, 0};
+    int fields = 0;
+    int differing = 0;
+    for (Tile *tile : tiles) {
+        for (enum character_type trainer_type : {RIVAL, HIKER}) {
+            for (int i = 0; i < cells; i++) {
+                const Terrain &terrain = tile->terrain_at(i % TILE_WIDTH_X, i / TILE_WIDTH_X);
+                weights[i] = trainer_type == RIVAL ? terrain.rival_weight : terrain.hiker_weight;
+            }
+            for (int source = 0; source < 10; source++) {
+                int x;
+                int y;
+                random_path_cell(tile, x, y);
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                distance_field(tile, trainer_type, expected, x, y);
+                field_seconds[0] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                fields++;
+                //relaxes the neighbors of cell with lower, a function taking a neighbor and its new distance
+                auto relax = [&](int cell, auto lower) {
+                    int cell_x = cell % TILE_WIDTH_X;
+                    int cell_y = cell / TILE_WIDTH_X;
+                    for (int d = 0; d < 8; d++) {
+                        int neighbor_x = cell_x + direction_x[d];
+                        int neighbor_y = cell_y + direction_y[d];
+                        if (neighbor_x < 0 || neighbor_x >= TILE_WIDTH_X || neighbor_y < 0
+                            || neighbor_y >= TILE_LENGTH_Y) {
+                            continue;
+                        }
+                        int neighbor = neighbor_y * TILE_WIDTH_X + neighbor_x;
+                        if (weights[neighbor] != INT_MAX
+                            && distances[cell].distance + weights[neighbor] < distances[neighbor].distance) {
+                            lower(neighbor, distances[cell].distance + weights[neighbor]);
+                        }
+                    }
+                };
+                auto reset = [&]() {
+                    for (int i = 0; i < cells; i++) {
+                        distances[i].distance = INT_MAX;
+                        distances[i].index = i;
+                    }
+                    distances[y * TILE_WIDTH_X + x].distance = 0;
+                };
+                auto check = [&]() {
+                    for (int i = 0; i < cells; i++) {
+                        if (distances[i].distance != expected[i / TILE_WIDTH_X][i % TILE_WIDTH_X]) {
+                            differing++;
+                            return;
+                        }
+                    }
+                };
+
+                start = std::chrono::steady_clock::now();
+                reset();
+                heap_init(&fibonacci_heap, compare_cells, NULL);
+                memset(fibonacci_nodes, 0, sizeof(fibonacci_nodes));
+                fibonacci_nodes[y * TILE_WIDTH_X + x] = heap_insert(&fibonacci_heap, &distances[y * TILE_WIDTH_X + x]);
+                while (heap_peek_min(&fibonacci_heap) != NULL) {
+                    Cell *cell = (Cell *) heap_remove_min(&fibonacci_heap);
+                    relax(cell->index, [&](int neighbor, int distance) {
+                        distances[neighbor].distance = distance;
+                        if (fibonacci_nodes[neighbor] == NULL) {
+                            fibonacci_nodes[neighbor] = heap_insert(&fibonacci_heap, &distances[neighbor]);
+                        }
+                        else {
+                            heap_decrease_key_no_replace(&fibonacci_heap, fibonacci_nodes[neighbor]);
+                        }
+                    });
+                }
+                heap_delete(&fibonacci_heap);
+                field_seconds[1] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                check();
+
+                start = std::chrono::steady_clock::now();
+                reset();
+                indexed_heap.push(y * TILE_WIDTH_X + x, 0);
+                while (!indexed_heap.empty()) {
+                    relax((int) indexed_heap.pop(), [&](int neighbor, int distance) {
+                        distances[neighbor].distance = distance;
+                        indexed_heap.push_or_decrease(neighbor, distance);
+                    });
+                }
+                field_seconds[2] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                check();
+
+                start = std::chrono::steady_clock::now();
+                reset();
+                cell_pairing_heap.clear();
+                memset(pairing_nodes, 0, sizeof(pairing_nodes));
+                pairing_nodes[y * TILE_WIDTH_X + x] = cell_pairing_heap.push({0, y * TILE_WIDTH_X + x});
+                while (!cell_pairing_heap.empty()) {
+                    relax(cell_pairing_heap.pop().second, [&](int neighbor, int distance) {
+                        distances[neighbor].distance = distance;
+                        if (pairing_nodes[neighbor] == NULL) {
+                            pairing_nodes[neighbor] = cell_pairing_heap.push({distance, neighbor});
+                        }
+                        else {
+                            cell_pairing_heap.decrease(pairing_nodes[neighbor], {distance, neighbor});
+                        }
+                    });
+                }
+                field_seconds[3] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                check();
+            }
+        }
+        delete_tile(tile);
+    }
+    std::cout << fields << " distance fields: heap.c " << field_seconds[1] * 1e6 / fields << " us, indexed 4-ary heap "
+              << field_seconds[2] * 1e6 / fields << " us, pairing heap " << field_seconds[3] * 1e6 / fields
+              << " us, buckets (distance_field) " << field_seconds[0] * 1e6 / fields << " us" << "\n";
+    std::cout << "Distance fields differing from distance_field: " << differing << "\n";
+
+    return ordered && agree && differing == 0 ? 0 : 1;
+
+}
+
+/*
+ * Steps the random walkers, pacers and wanderers of num_tiles tiles for num_turns turns, one at a time through a turn
+ * scheduler and move_trainer as when the PC is on a tile, and in batches of one type as when a tile catches up.
+ */
+int benchmark_walkers(int num_tiles, int num_turns) {
+
+    //terrain only, with walkers (without pokemon, which need the pokedex) put on the same cells of both copies
+    srand(1);
+    std::vector<Tile *> scheduled = create_trainerless_tiles(num_tiles);
+    std::vector<Tile *> batched;
+    static const enum character_type walker_types[3] = {RANDOM_WALKER, PACER, WANDERER};
+    for (int i = 0; i < num_tiles; i++) {
+        batched.push_back(new Tile(*scheduled[i]));
+        batched.back()->characters.clear();
+        for (int placed = 0; placed < 40;) {
+            int x = rand() % (TILE_WIDTH_X - 2) + 1;
+            int y = rand() % (TILE_LENGTH_Y - 2) + 1;
+            if ((scheduled[i]->passable[y][x / 32] & (1u << (x % 32)))
+                && scheduled[i]->character_at(x, y) == NULL) {
+                enum character_type type = walker_types[placed % 3];
+                scheduled[i]->set_character(x, y, new Character(x, y, type, "", 'w', RED, 0, 0, 0, 0, 0, 0));
+                batched.back()->set_character(x, y, new Character(x, y, type, "", 'w', RED, 0, 0, 0, 0, 0, 0));
+                placed++;
+            }
+        }
+    }
+
+    long scheduled_steps = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (Tile *tile : scheduled) {
+        TurnScheduler scheduler;
+        for (Character *character : tile->characters) {
+            if (character->type_enum == RANDOM_WALKER || character->type_enum == PACER
+                || character->type_enum == WANDERER) {
+                scheduler.insert(character);
+            }
+        }
+        Character *character;
+        while ((character = scheduler.pop()) != NULL && character->turn < num_turns) {
+            move_trainer(tile, character);
+            scheduler.insert(character);
+            scheduled_steps++;
+        }
+    }
+    double scheduled_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long batched_steps = 0;
+    start = std::chrono::steady_clock::now();
+    for (Tile *tile : batched) {
+        WalkerBatch batches[3];
+        for (int i = 0; i < 3; i++) {
+            batches[i].gather(tile, walker_types[i]);
+        }
+        int stepped = 1;
+        while (stepped > 0) {
+            stepped = 0;
+            for (int i = 0; i < 3; i++) {
+                stepped += batches[i].step(tile, num_turns);
+            }
+            batched_steps += stepped;
+        }
+        for (int i = 0; i < 3; i++) {
+            batches[i].scatter();
+        }
+    }
+    double batched_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    //every trainer must still be where its tile says it is
+    int misplaced = 0;
+    for (int i = 0; i < num_tiles; i++) {
+        for (Tile *tile : {scheduled[i], batched[i]}) {
+            for (Character *character : tile->characters) {
+                if (tile->character_at(character->x, character->y) != character) {
+                    misplaced++;
+                }
+            }
+        }
+        delete_tile(scheduled[i]);
+        delete_tile(batched[i]);
+    }
+    std::cout << "Walking trainers on " << num_tiles << " tiles for " << num_turns << " turns: one at a time "
+              << scheduled_steps / scheduled_seconds << " steps/s, batched " << batched_steps / batched_seconds
+              << " steps/s " << (batched_steps / batched_seconds) / (scheduled_steps / scheduled_seconds) << "x"
+              << "\n";
+    std::cout << "Trainers out of place: " << misplaced << "\n";
+
+    return misplaced == 0 ? 0 : 1;
+
+}
+
+/*
+ * Walks the PC num_moves cells at random on each of num_tiles tiles and keeps rival and hiker distances up to date,
+ * by recomputing them every move and by updating them, checking both agree.
+ */
+int benchmark_distances(int num_tiles, int num_moves) {
+
+    std::vector<Tile *> tiles = create_trainerless_tiles(num_tiles);
+    srand(1);
+
+    static const enum character_type trainer_types[2] = {RIVAL, HIKER};
+    static int recomputed[TILE_LENGTH_Y][TILE_WIDTH_X];
+    static int updated[2][TILE_LENGTH_Y][TILE_WIDTH_X];
+    double recompute_seconds = 0;
+    double update_seconds = 0;
+    long recompute_settled = 0;
+    long update_settled = 0;
+    int differing = 0;
+    for (Tile *tile : tiles) {
+        int x;
+        int y;
+        random_path_cell(tile, x, y);
+        for (int i = 0; i < 2; i++) {
+            distance_field(tile, trainer_types[i], updated[i], x, y);
+        }
+        for (int move = 0; move < num_moves; move++) {
+            int new_x;
+            int new_y;
+            random_pc_step(tile, x, y, new_x, new_y);
+            for (int i = 0; i < 2; i++) {
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                recompute_settled += distance_field(tile, trainer_types[i], recomputed, new_x, new_y);
+                recompute_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                start = std::chrono::steady_clock::now();
+                update_settled += update_distance_field(tile, trainer_types[i], updated[i], x, y, new_x, new_y);
+                update_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (memcmp(recomputed, updated[i], sizeof(recomputed)) != 0) {
+                    differing++;
+                }
+            }
+            x = new_x;
+            y = new_y;
+        }
+        delete_tile(tile);
+    }
+    long updates = (long) num_tiles * num_moves * 2;
+    std::cout << "Distance fields over " << updates / 2 << " PC moves: recomputed " << recompute_seconds * 1e6 / updates
+              << " us and " << recompute_settled / updates << " cells per field, updated "
+              << update_seconds * 1e6 / updates << " us and " << update_settled / updates << " cells per field "
+              << recompute_seconds / update_seconds << "x" << "\n";
+    std::cout << "Updated distances differing from recomputed ones: " << differing << "\n";
+
+    return differing == 0 ? 0 : 1;
+
+}
+
+/*
+ * Paces the PC num_moves cells on each of num_tiles tiles, stepping back where it came from every other move on
+ * average, and keeps rival and hiker distances up to date by updating them and through the tile's distance cache,
+ * checking both agree.
+ */
+int benchmark_distance_cache(int num_tiles, int num_moves) {
+
+    std::vector<Tile *> tiles = create_trainerless_tiles(num_tiles);
+    srand(1);
+
+    static const enum character_type trainer_types[2] = {RIVAL, HIKER};
+    static int updated[2][TILE_LENGTH_Y][TILE_WIDTH_X];
+    Character pacer(0, 0, PLAYER, "PLAYER", '@', CYAN, 0, 0, 0, 0, 0, 0);
+    double update_seconds = 0;
+    double cache_seconds = 0;
+    long hits = 0;
+    long misses = 0;
+    int differing = 0;
+    for (Tile *tile : tiles) {
+        int x;
+        int y;
+        random_path_cell(tile, x, y);
+        pacer.x = x;
+        pacer.y = y;
+        tile->player_character = (PlayerCharacter *) &pacer;
+        for (int i = 0; i < 2; i++) {
+            distance_field(tile, trainer_types[i], updated[i], x, y);
+            dijkstra(tile, trainer_types[i]);
+        }
+        int previous_x = x;
+        int previous_y = y;
+        for (int move = 0; move < num_moves; move++) {
+            int new_x = previous_x;
+            int new_y = previous_y;
+            if (rand() % 2 == 0 || (new_x == x && new_y == y)) {
+                random_pc_step(tile, x, y, new_x, new_y);
+            }
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (int i = 0; i < 2; i++) {
+                update_distance_field(tile, trainer_types[i], updated[i], x, y, new_x, new_y);
+            }
+            update_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            pacer.x = new_x;
+            pacer.y = new_y;
+            start = std::chrono::steady_clock::now();
+            update_distances(tile, RIVAL, x, y);
+            update_distances(tile, HIKER, x, y);
+            cache_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (memcmp(updated[0], rival_distance_tile, sizeof(rival_distance_tile)) != 0
+                || memcmp(updated[1], hiker_distance_tile, sizeof(hiker_distance_tile)) != 0) {
+                differing++;
+            }
+            previous_x = x;
+            previous_y = y;
+            x = new_x;
+            y = new_y;
+        }
+        hits += tile->distances.hits;
+        misses += tile->distances.misses;
+        tile->player_character = NULL;
+        delete_tile(tile);
+    }
+    delete pacer.bag;
+    long moves = (long) num_tiles * num_moves;
+    std::cout << "Distance fields over " << moves << " PC moves pacing: updated " << update_seconds * 1e6 / moves
+              << " us per move, cached " << cache_seconds * 1e6 / moves << " us per move "
+              << update_seconds / cache_seconds << "x" << "\n";
+    std::cout << "Distance cache hits: " << hits << ", misses: " << misses << " ("
+              << 100.0 * hits / (hits + misses) << "% hits)" << "\n";
+    std::cout << "Cached distances differing from updated ones: " << differing << "\n";
+
+    return differing == 0 ? 0 : 1;
+
+}
+
 int place_edge(Tile *tile) {
 
     //places edge (stones with different name and higher weight) on edges
     for (int i = 0; i < TILE_WIDTH_X; i ++) {
-        tile->tile[0][i].terrain = *edge;
-        tile->tile[TILE_LENGTH_Y - 1][i].terrain = *edge;
+        tile->terrain[0][i] = edge->id;
+        tile->terrain[TILE_LENGTH_Y - 1][i] = edge->id;
     }
     for (int i = 0; i < TILE_LENGTH_Y; i ++) {
-        tile->tile[i][0].terrain = *edge;
-        tile->tile[i][TILE_WIDTH_X - 1].terrain = *edge;
+        tile->terrain[i][0] = edge->id;
+        tile->terrain[i][TILE_WIDTH_X - 1] = edge->id;
     }
 
     return 0;
@@ -3663,15 +7082,15 @@ int set_terrain_border_weights(Tile *tile) {
     //Sets borders between non-edge Terrain types to weight 0
     for (int i = 1; i < TILE_LENGTH_Y - 1; i++) {
         for (int j = 1; j < TILE_WIDTH_X - 1; j++) {
-            Terrain terrain = tile->tile[i][j].terrain;
+            uint8_t terrain = tile->terrain[i][j];
             for (int k = -1; k <=1; k++) {
                 for (int l = -1; l <= 1; l++) {
                     int x = j+k;
                     int y = i+l;
                     if (x > 0 && x < TILE_WIDTH_X - 1 && y > 0 && y < TILE_LENGTH_Y - 1) {
-                        Terrain other_terrain = tile->tile[y][x].terrain;
-                        if (terrain.id != other_terrain.id && other_terrain.id != edge->id) {
-                            tile->tile[i][j].terrain.path_weight = TERRAIN_BORDER_WEIGHT;
+                        uint8_t other_terrain = tile->terrain[y][x];
+                        if (terrain != other_terrain && other_terrain != edge->id) {
+                            tile->set_border(j, i);
                         }
                     }
                 }
@@ -3703,7 +7122,7 @@ int generate_paths(Tile *tile, int north_x, int south_x, int east_y, int west_y)
     current_y = 0;
     last_move = 'x';
     moves_since_last_change = 0;
-    tile->tile[current_y][current_x].terrain = *path;
+    tile->set_terrain(current_x, current_y, path->id);
     while (current_y < TILE_LENGTH_Y - 2) {
         //determine weights
         int east_weight = INT_MAX;
@@ -3711,18 +7130,18 @@ int generate_paths(Tile *tile, int north_x, int south_x, int east_y, int west_y)
         int south_weight = INT_MAX;
         if (current_x < TILE_WIDTH_X - 4 && last_move != 'w'
             && !(moves_since_last_change > repetitive_limit && last_move == 'e')) {
-            east_weight = tile->tile[current_y][current_x + 1].terrain.path_weight;
+            east_weight = tile->path_weight_at(current_x + 1, current_y);
         }
         if (current_x > 2 && last_move != 'e' && !(moves_since_last_change > repetitive_limit && last_move == 'w')) {
-            west_weight = tile->tile[current_y][current_x - 1].terrain.path_weight;
+            west_weight = tile->path_weight_at(current_x - 1, current_y);
         }
         if (current_y < TILE_LENGTH_Y - 1 && !(moves_since_last_change > repetitive_limit && last_move == 's')) {
-            south_weight = tile->tile[current_y + 1][current_x].terrain.path_weight;
+            south_weight = tile->path_weight_at(current_x, current_y + 1);
         }
         //choose the lowest weight
         if (east_weight < west_weight && east_weight < south_weight) {
             current_x++;
-            tile->tile[current_y][current_x].terrain = *path;
+            tile->set_terrain(current_x, current_y, path->id);
             if (last_move == 'e') {
                 moves_since_last_change++;
             }
@@ -3733,7 +7152,7 @@ int generate_paths(Tile *tile, int north_x, int south_x, int east_y, int west_y)
         }
         else if (west_weight < south_weight) {
             current_x--;
-            tile->tile[current_y][current_x].terrain = *path;
+            tile->set_terrain(current_x, current_y, path->id);
             if (last_move == 'w') {
                 moves_since_last_change++;
             }
@@ -3744,7 +7163,7 @@ int generate_paths(Tile *tile, int north_x, int south_x, int east_y, int west_y)
         }
         else {
             current_y++;
-            tile->tile[current_y][current_x].terrain = *path;
+            tile->set_terrain(current_x, current_y, path->id);
             if (last_move == 's') {
                 moves_since_last_change++;
             }
@@ -3757,23 +7176,23 @@ int generate_paths(Tile *tile, int north_x, int south_x, int east_y, int west_y)
     if (current_x < south_x) {
         for (int i = current_x; i <= south_x; i++) {
             current_x = i;
-            tile->tile[current_y][current_x].terrain = *path;
+            tile->set_terrain(current_x, current_y, path->id);
         }
     }
     else if (current_x > south_x) {
         for (int i = current_x; i >= south_x; i--) {
             current_x = i;
-            tile->tile[current_y][current_x].terrain = *path;
+            tile->set_terrain(current_x, current_y, path->id);
         }
     }
-    tile->tile[current_y + 1][current_x].terrain = *path;
+    tile->set_terrain(current_x, current_y + 1, path->id);
 
     //West/East path
     current_x = 0;
     current_y = west_y;
     last_move = 'x';
     moves_since_last_change = 0;
-    tile->tile[current_y][current_x].terrain = *path;
+    tile->set_terrain(current_x, current_y, path->id);
     while (current_x < TILE_WIDTH_X - 2) {
         //determine weights
         int north_weight = INT_MAX;
@@ -3781,18 +7200,18 @@ int generate_paths(Tile *tile, int north_x, int south_x, int east_y, int west_y)
         int east_weight = INT_MAX;
         if (current_y < TILE_LENGTH_Y - 3 && last_move != 'n'
             && !(moves_since_last_change > repetitive_limit && last_move == 's')) {
-            south_weight = tile->tile[current_y + 1][current_x].terrain.path_weight;
+            south_weight = tile->path_weight_at(current_x, current_y + 1);
         }
         if (current_y > 2 && last_move != 's' && !(moves_since_last_change > repetitive_limit && last_move == 'n')) {
-            north_weight = tile->tile[current_y - 1][current_x].terrain.path_weight;
+            north_weight = tile->path_weight_at(current_x, current_y - 1);
         }
         if (current_x < TILE_WIDTH_X - 2 && !(moves_since_last_change > repetitive_limit && last_move == 'e')) {
-            east_weight = tile->tile[current_y][current_x + 1].terrain.path_weight;
+            east_weight = tile->path_weight_at(current_x + 1, current_y);
         }
         //choose the lowest weight
         if (north_weight < south_weight && north_weight < east_weight) {
             current_y--;
-            tile->tile[current_y][current_x].terrain = *path;
+            tile->set_terrain(current_x, current_y, path->id);
             if (last_move == 'n') {
                 moves_since_last_change++;
             }
@@ -3803,7 +7222,7 @@ int generate_paths(Tile *tile, int north_x, int south_x, int east_y, int west_y)
         }
         else if (south_weight < east_weight) {
             current_y++;
-            tile->tile[current_y][current_x].terrain = *path;
+            tile->set_terrain(current_x, current_y, path->id);
             if (last_move == 's') {
                 moves_since_last_change++;
             }
@@ -3814,7 +7233,7 @@ int generate_paths(Tile *tile, int north_x, int south_x, int east_y, int west_y)
         }
         else {
             current_x++;
-            tile->tile[current_y][current_x].terrain = *path;
+            tile->set_terrain(current_x, current_y, path->id);
             if (last_move == 'e') {
                 moves_since_last_change++;
             }
@@ -3827,16 +7246,16 @@ int generate_paths(Tile *tile, int north_x, int south_x, int east_y, int west_y)
     if (current_y < east_y) {
         for (int i = current_y; i <= east_y; i++) {
             current_y = i;
-            tile->tile[current_y][current_x].terrain = *path;
+            tile->set_terrain(current_x, current_y, path->id);
         }
     }
     else if (current_y > east_y) {
         for (int i = current_y; i >= east_y; i--) {
             current_y = i;
-            tile->tile[current_y][current_x].terrain = *path;
+            tile->set_terrain(current_x, current_y, path->id);
         }
     }
-    tile->tile[current_y][current_x + 1].terrain = *path;
+    tile->set_terrain(current_x + 1, current_y, path->id);
 
     tile->north_x = north_x;
     tile->south_x = south_x;
@@ -3989,33 +7408,32 @@ int generate_buildings(Tile *tile, int x, int y) {
             chance = 5;
         }
     }
-    place_building(tile, *center, chance);
-    place_building(tile, *mart, chance);
+    place_building(tile, center->id, chance);
+    place_building(tile, mart->id, chance);
 
     return 0;
 
 }
 
-int place_building(Tile *tile, Terrain terrain, double chance) {
+int place_building(Tile *tile, int terrain, double chance) {
 
-    if (rand() % 100 < chance) {
+    if (random_below(100) < chance) {
         int x;
         int y;
         int valid = 1;
         while (valid == 1) {
-            x = rand() % (TILE_WIDTH_X - 2) + 1;
-            y = rand() % (TILE_LENGTH_Y - 2) + 1;
-            Point point = tile->tile[y][x];
-            if (!legal_overwrite(point)) {
-                if ((x > 0 && tile->tile[y][x - 1].terrain.id == path->id)
-                    || (x < TILE_WIDTH_X - 1 && tile->tile[y][x + 1].terrain.id == path->id)
-                    || (y > 0 && tile->tile[y - 1][x].terrain.id == path->id)
-                    || (y < TILE_LENGTH_Y - 1 && tile->tile[y + 1][x].terrain.id == path->id)) {
+            x = random_below(TILE_WIDTH_X - 2) + 1;
+            y = random_below(TILE_LENGTH_Y - 2) + 1;
+            if (!legal_overwrite(tile->terrain[y][x])) {
+                if ((x > 0 && tile->terrain[y][x - 1] == path->id)
+                    || (x < TILE_WIDTH_X - 1 && tile->terrain[y][x + 1] == path->id)
+                    || (y > 0 && tile->terrain[y - 1][x] == path->id)
+                    || (y < TILE_LENGTH_Y - 1 && tile->terrain[y + 1][x] == path->id)) {
                     valid = 0;
                 }
             }
         }
-        tile->tile[y][x].terrain = terrain;
+        tile->set_terrain(x, y, terrain);
     }
 
     return 0;
@@ -4030,7 +7448,7 @@ int place_final_boss(Tile *tile) {
         while (found == 0) {
             x = rand() % 78 + 1;
             y = rand() % 19 + 1;
-            if (tile->tile[y][x].character == NULL && tile->tile[y][x].terrain.id == path->id) {
+            if (tile->character_at(x, y) == NULL && tile->terrain[y][x] == path->id) {
                 found = 1;
             }
         }
@@ -4038,13 +7456,13 @@ int place_final_boss(Tile *tile) {
                                            RED, 0, 0, 0, 0,
                                            0, 0);
         for (int i = 0; i < 6; i++) {
-            Pokemon *pokemon = create_pokemon();
-            pokemon->level = 10;
-            pokemon->maxHealth += 50;
-            pokemon->health += 50;
+            Pokemon pokemon = create_pokemon(current_tile_x, current_tile_y);
+            pokemon.restore(10);
+            pokemon.maxHealth += 50;
+            pokemon.health += 50;
             trainer->activePokemon.push_back(pokemon);
         }
-        tile->tile[y][x].character = trainer;
+        tile->set_character(x, y, trainer);
 
     return 0;
 
@@ -4058,7 +7476,7 @@ int place_player_character(Tile *tile) {
     while (found == 0) {
         x = rand() % 78 + 1;
         y = rand() % 19 + 1;
-        if (tile->tile[y][x].terrain.id == path->id) {
+        if (tile->terrain[y][x] == path->id) {
             found = 1;
         }
     }
@@ -4067,8 +7485,9 @@ int place_player_character(Tile *tile) {
                                      0, 0, 0, 0, 0, 0);
     select_pokemon(player_character);
     tile->player_character = (PlayerCharacter *) player_character;
-    tile->tile[y][x].character = player_character;
-    heap_insert(&turn_heap, player_character);
+    tile->visited = true;
+    tile->set_character(x, y, player_character);
+    tile->scheduler.insert(player_character);
     //create distance tiles
     dijkstra(tile, RIVAL);
     dijkstra(tile, HIKER);
@@ -4085,9 +7504,9 @@ int select_pokemon(Character *playerCharacter) {
     else {
 
         //create pokemon choices
-        Pokemon *pokemon1 = create_pokemon();
-        Pokemon *pokemon2 = create_pokemon();
-        Pokemon *pokemon3 = create_pokemon();
+        Pokemon pokemon1 = create_pokemon(current_tile_x, current_tile_y);
+        Pokemon pokemon2 = create_pokemon(current_tile_x, current_tile_y);
+        Pokemon pokemon3 = create_pokemon(current_tile_x, current_tile_y);
 
         //present pokemon choices to player
         interface->clearUI();
@@ -4099,91 +7518,91 @@ int select_pokemon(Character *playerCharacter) {
 
         interface->mvaddstrUI(lineNumber, 0, "Option: ");
         interface->mvaddstrUI(lineNumber, 20, "1. ");
-        interface->addstrUI(pokemon1->pokemonInfo->name.c_str());
+        interface->addstrUI(pokemon1.info().getName());
         interface->mvaddstrUI(lineNumber, 40, "2. ");
-        interface->addstrUI(pokemon2->pokemonInfo->name.c_str());
+        interface->addstrUI(pokemon2.info().getName());
         interface->mvaddstrUI(lineNumber, 60, "3. ");
-        interface->addstrUI(pokemon3->pokemonInfo->name.c_str());
+        interface->addstrUI(pokemon3.info().getName());
         lineNumber++;
 
         interface->mvaddstrUI(lineNumber, 0, "Level: ");
-        interface->mvaddstrUI(lineNumber, 20, std::to_string(pokemon1->level).c_str());
-        interface->mvaddstrUI(lineNumber, 40, std::to_string(pokemon2->level).c_str());
-        interface->mvaddstrUI(lineNumber, 60, std::to_string(pokemon3->level).c_str());
+        interface->mvaddstrUI(lineNumber, 20, std::to_string(pokemon1.level).c_str());
+        interface->mvaddstrUI(lineNumber, 40, std::to_string(pokemon2.level).c_str());
+        interface->mvaddstrUI(lineNumber, 60, std::to_string(pokemon3.level).c_str());
         lineNumber++;
 
         interface->mvaddstrUI(lineNumber, 0, "Move 1: ");
-        interface->mvaddstrUI(lineNumber, 20, pokemon1->moves.at(0)->name.c_str());
-        interface->mvaddstrUI(lineNumber, 40, pokemon2->moves.at(0)->name.c_str());
-        interface->mvaddstrUI(lineNumber, 60, pokemon3->moves.at(0)->name.c_str());
+        interface->mvaddstrUI(lineNumber, 20, pokemon1.getMove(0).getName());
+        interface->mvaddstrUI(lineNumber, 40, pokemon2.getMove(0).getName());
+        interface->mvaddstrUI(lineNumber, 60, pokemon3.getMove(0).getName());
         lineNumber++;
 
         interface->mvaddstrUI(lineNumber, 0, "Move 2: ");
-        if (pokemon1->moves.size() > 1) {
-            interface->mvaddstrUI(lineNumber, 20, pokemon1->moves.at(1)->name.c_str());
+        if (pokemon1.moveCount > 1) {
+            interface->mvaddstrUI(lineNumber, 20, pokemon1.getMove(1).getName());
         } else {
             interface->mvaddstrUI(lineNumber, 20, "none");
         }
-        if (pokemon1->moves.size() > 1) {
-            interface->mvaddstrUI(lineNumber, 40, pokemon2->moves.at(1)->name.c_str());
+        if (pokemon2.moveCount > 1) {
+            interface->mvaddstrUI(lineNumber, 40, pokemon2.getMove(1).getName());
         } else {
             interface->mvaddstrUI(lineNumber, 40, "none");
         }
-        if (pokemon1->moves.size() > 1) {
-            interface->mvaddstrUI(lineNumber, 60, pokemon3->moves.at(1)->name.c_str());
+        if (pokemon3.moveCount > 1) {
+            interface->mvaddstrUI(lineNumber, 60, pokemon3.getMove(1).getName());
         } else {
             interface->mvaddstrUI(lineNumber, 60, "none");
         }
         lineNumber++;
 
         interface->mvaddstrUI(lineNumber, 0, "HP: ");
-        interface->mvaddstrUI(lineNumber, 20, std::to_string(pokemon1->getHealth()).c_str());
-        interface->mvaddstrUI(lineNumber, 40, std::to_string(pokemon2->getHealth()).c_str());
-        interface->mvaddstrUI(lineNumber, 60, std::to_string(pokemon3->getHealth()).c_str());
+        interface->mvaddstrUI(lineNumber, 20, std::to_string(pokemon1.getHealth()).c_str());
+        interface->mvaddstrUI(lineNumber, 40, std::to_string(pokemon2.getHealth()).c_str());
+        interface->mvaddstrUI(lineNumber, 60, std::to_string(pokemon3.getHealth()).c_str());
         lineNumber++;
 
         interface->mvaddstrUI(lineNumber, 0, "Attack: ");
-        interface->mvaddstrUI(lineNumber, 20, std::to_string(pokemon1->getAttack()).c_str());
-        interface->mvaddstrUI(lineNumber, 40, std::to_string(pokemon2->getAttack()).c_str());
-        interface->mvaddstrUI(lineNumber, 60, std::to_string(pokemon3->getAttack()).c_str());
+        interface->mvaddstrUI(lineNumber, 20, std::to_string(pokemon1.getAttack()).c_str());
+        interface->mvaddstrUI(lineNumber, 40, std::to_string(pokemon2.getAttack()).c_str());
+        interface->mvaddstrUI(lineNumber, 60, std::to_string(pokemon3.getAttack()).c_str());
         lineNumber++;
 
         interface->mvaddstrUI(lineNumber, 0, "Defense: ");
-        interface->mvaddstrUI(lineNumber, 20, std::to_string(pokemon1->getDefense()).c_str());
-        interface->mvaddstrUI(lineNumber, 40, std::to_string(pokemon2->getDefense()).c_str());
-        interface->mvaddstrUI(lineNumber, 60, std::to_string(pokemon3->getDefense()).c_str());
+        interface->mvaddstrUI(lineNumber, 20, std::to_string(pokemon1.getDefense()).c_str());
+        interface->mvaddstrUI(lineNumber, 40, std::to_string(pokemon2.getDefense()).c_str());
+        interface->mvaddstrUI(lineNumber, 60, std::to_string(pokemon3.getDefense()).c_str());
         lineNumber++;
 
         interface->mvaddstrUI(lineNumber, 0, "Special Attack: ");
-        interface->mvaddstrUI(lineNumber, 20, std::to_string(pokemon1->getSpecialAttack()).c_str());
-        interface->mvaddstrUI(lineNumber, 40, std::to_string(pokemon2->getSpecialAttack()).c_str());
-        interface->mvaddstrUI(lineNumber, 60, std::to_string(pokemon3->getSpecialAttack()).c_str());
+        interface->mvaddstrUI(lineNumber, 20, std::to_string(pokemon1.getSpecialAttack()).c_str());
+        interface->mvaddstrUI(lineNumber, 40, std::to_string(pokemon2.getSpecialAttack()).c_str());
+        interface->mvaddstrUI(lineNumber, 60, std::to_string(pokemon3.getSpecialAttack()).c_str());
         lineNumber++;
 
         interface->mvaddstrUI(lineNumber, 0, "Special Defense: ");
-        interface->mvaddstrUI(lineNumber, 20, std::to_string(pokemon1->getSpecialDefense()).c_str());
-        interface->mvaddstrUI(lineNumber, 40, std::to_string(pokemon2->getSpecialDefense()).c_str());
-        interface->mvaddstrUI(lineNumber, 60, std::to_string(pokemon3->getSpecialDefense()).c_str());
+        interface->mvaddstrUI(lineNumber, 20, std::to_string(pokemon1.getSpecialDefense()).c_str());
+        interface->mvaddstrUI(lineNumber, 40, std::to_string(pokemon2.getSpecialDefense()).c_str());
+        interface->mvaddstrUI(lineNumber, 60, std::to_string(pokemon3.getSpecialDefense()).c_str());
         lineNumber++;
 
         interface->mvaddstrUI(lineNumber, 0, "Speed: ");
-        interface->mvaddstrUI(lineNumber, 20, std::to_string(pokemon1->getSpeed()).c_str());
-        interface->mvaddstrUI(lineNumber, 40, std::to_string(pokemon2->getSpeed()).c_str());
-        interface->mvaddstrUI(lineNumber, 60, std::to_string(pokemon3->getSpeed()).c_str());
+        interface->mvaddstrUI(lineNumber, 20, std::to_string(pokemon1.getSpeed()).c_str());
+        interface->mvaddstrUI(lineNumber, 40, std::to_string(pokemon2.getSpeed()).c_str());
+        interface->mvaddstrUI(lineNumber, 60, std::to_string(pokemon3.getSpeed()).c_str());
         lineNumber++;
 
         interface->mvaddstrUI(lineNumber, 0, "Gender: ");
-        if (pokemon1->male == true) {
+        if (pokemon1.male == true) {
             interface->mvaddstrUI(lineNumber, 20, "Male");
         } else {
             interface->mvaddstrUI(lineNumber, 20, "Female");
         }
-        if (pokemon2->male == true) {
+        if (pokemon2.male == true) {
             interface->mvaddstrUI(lineNumber, 40, "Male");
         } else {
             interface->mvaddstrUI(lineNumber, 40, "Female");
         }
-        if (pokemon3->male == true) {
+        if (pokemon3.male == true) {
             interface->mvaddstrUI(lineNumber, 60, "Male");
         } else {
             interface->mvaddstrUI(lineNumber, 60, "Female");
@@ -4191,17 +7610,17 @@ int select_pokemon(Character *playerCharacter) {
         lineNumber++;
 
         interface->mvaddstrUI(lineNumber, 0, "Shiny: ");
-        if (pokemon1->shiny == true) {
+        if (pokemon1.shiny == true) {
             interface->mvaddstrUI(lineNumber, 20, "Yes");
         } else {
             interface->mvaddstrUI(lineNumber, 20, "No");
         }
-        if (pokemon2->shiny == true) {
+        if (pokemon2.shiny == true) {
             interface->mvaddstrUI(lineNumber, 40, "Yes");
         } else {
             interface->mvaddstrUI(lineNumber, 40, "No");
         }
-        if (pokemon3->shiny == true) {
+        if (pokemon3.shiny == true) {
             interface->mvaddstrUI(lineNumber, 60, "Yes");
         } else {
             interface->mvaddstrUI(lineNumber, 60, "No");
@@ -4214,13 +7633,13 @@ int select_pokemon(Character *playerCharacter) {
         while (true) {
             const char choice = interface->getchUI();
             if (choice == '1') {
-                chosenPokemon = pokemon1;
+                chosenPokemon = &pokemon1;
                 break;
             } else if (choice == '2') {
-                chosenPokemon = pokemon2;
+                chosenPokemon = &pokemon2;
                 break;
             } else if (choice == '3') {
-                chosenPokemon = pokemon3;
+                chosenPokemon = &pokemon3;
                 break;
             } else {
                 interface->mvaddstrUI(0, 0, &choice);
@@ -4228,7 +7647,7 @@ int select_pokemon(Character *playerCharacter) {
                         " is not a valid input. Please input 1/2/3 to choose the respective starting pokemon!");
             }
         }
-        playerCharacter->activePokemon.push_back(chosenPokemon);
+        playerCharacter->activePokemon.push_back(*chosenPokemon);
 
     }
 
@@ -4238,32 +7657,32 @@ int select_pokemon(Character *playerCharacter) {
 
 int select_pokemon_cheating(Character *playerCharacter) {
 
-    PokemonInfo *pokemonInfo = new PokemonInfo("99999", "Professor Sheaffer", "99999", "6",
-                                               "200", "1000", "1", "1");
-    std::vector<Move *> moves;
-    Move *move1 = new Move("99996", "Assign Homework", "99999", "99999", "20",
-                           "100", "100", "100", "99999", "99999",
-                           "99999","100", "99999", "99999",
-                           "99999");
-    Move *move2 = new Move("99997", "Cancel Exam", "99999", "99999", "0",
-                           "100", "100", "100", "99999", "99999",
-                           "99999","100", "99999", "99999",
-                           "99999");
-    Move *move3 = new Move("99998", "Calculator Show and Tell", "99999", "99999", "25",
-                           "100", "50", "100", "99999", "99999",
-                           "99999","100", "99999", "99999",
-                           "99999");
-    Move *move4 = new Move("99999", "Donald Duck Show and Tell", "99999", "99999", "100",
-                           "100", "50", "100", "99999", "99999",
-                           "99999","100", "99999", "99999",
-                           "99999");
-    moves.push_back(move1);
-    moves.push_back(move2);
-    moves.push_back(move3);
-    moves.push_back(move4);
-    Pokemon *pokemon = new Pokemon(pokemonInfo, 100, 100, 100, 100,
-                                   100, 100, 50, moves, true, true);
-    playerCharacter->activePokemon.push_back(pokemon);
+    PokemonInfo pokemonInfo("99999", "Professor Sheaffer", "99999", "6",
+                            "200", "1000", "1", "1");
+    std::vector<int> moves;
+    Move move1("99996", "Assign Homework", "99999", "99999", "20",
+               "100", "100", "100", "99999", "99999",
+               "99999","100", "99999", "99999",
+               "99999");
+    Move move2("99997", "Cancel Exam", "99999", "99999", "0",
+               "100", "100", "100", "99999", "99999",
+               "99999","100", "99999", "99999",
+               "99999");
+    Move move3("99998", "Calculator Show and Tell", "99999", "99999", "25",
+               "100", "50", "100", "99999", "99999",
+               "99999","100", "99999", "99999",
+               "99999");
+    Move move4("99999", "Donald Duck Show and Tell", "99999", "99999", "100",
+               "100", "50", "100", "99999", "99999",
+               "99999","100", "99999", "99999",
+               "99999");
+    moves.push_back(moveRegistry.add(move1));
+    moves.push_back(moveRegistry.add(move2));
+    moves.push_back(moveRegistry.add(move3));
+    moves.push_back(moveRegistry.add(move4));
+    int baseStats[6] = {100, 100, 100, 100, 100, 100};
+    int species = pokemonIndex.add(pokemonInfo, baseStats);
+    playerCharacter->activePokemon.push_back(Pokemon(species, 50, moves, true, true));
 
     return 0;
 
@@ -4287,7 +7706,7 @@ int place_trainers(Tile *tile) {
             num_hikers++;
         }
         else {
-            int random = rand()%10;
+            int random = random_below(10);
             if (random >= 0 && random <= 2) {
                 num_rivals++;
             }
@@ -4328,12 +7747,12 @@ int place_trainer_type(Tile *tile, int num_trainer, enum character_type trainer_
         int y;
         int found = 0;
         while (found == 0) {
-            x = rand() % 78 + 1;
-            y = rand() % 19 + 1;
-            if (tile->tile[y][x].character == NULL) {
+            x = random_below(78) + 1;
+            y = random_below(19) + 1;
+            if (tile->character_at(x, y) == NULL) {
                 //todo: BUG: once fixed Dijkstra distance to PC tile creation, uncomment commented code and delete place by PC can move over
                 //spawns anywhere PC can step on (not necessarily reach if surrounded by uncrossable)
-                if (tile->tile[y][x].terrain.rival_weight < INT_MAX) {
+                if (tile->terrain_at(x, y).rival_weight < INT_MAX) {
                     found = 1;
                 }
 //                if (trainer_type == HIKER) {
@@ -4378,18 +7797,17 @@ int place_trainer_type(Tile *tile, int num_trainer, enum character_type trainer_
                                            RED, 0, 0, 0, 0,
                                            0, 0);
         //todo: BUG: trainer pokemon are created as incredibly powerful (very high health), probably set to high level instead of lvl 1 in starting tile
-        trainer->activePokemon.push_back(create_pokemon());
+        trainer->activePokemon.push_back(create_pokemon(tile->x, tile->y));
         //60% chance for trainer to get another pokemon if just got a pokemon, up to 6
         for (int i = 0; i < 5; i++) {
-            if (rand() % 10 < 6) {
-                trainer->activePokemon.push_back(create_pokemon());
+            if (random_below(10) < 6) {
+                trainer->activePokemon.push_back(create_pokemon(tile->x, tile->y));
             }
             else {
                 break;
             }
         }
-        heap_insert(&turn_heap, trainer);
-        tile->tile[y][x].character = trainer;
+        tile->set_character(x, y, trainer);
         num_trainer--;
     }
 
@@ -4399,105 +7817,145 @@ int place_trainer_type(Tile *tile, int num_trainer, enum character_type trainer_
 
 int dijkstra(Tile *tile, enum character_type trainer_type) {
 
-    for (int y = 0; y < TILE_LENGTH_Y; y++) {
-        for (int x = 0; x < TILE_WIDTH_X; x++) {
-            tile->tile[y][x].distance = INT_MAX;
+    //updates appropriate trainer distance Tile for the data to endure through future dijkstra calls
+    int (*distances)[TILE_WIDTH_X] = trainer_type == RIVAL ? rival_distance_tile : hiker_distance_tile;
+    int x = tile->player_character->x;
+    int y = tile->player_character->y;
+    if (!tile->distances.load(trainer_type, x, y, distances)) {
+        distance_field(tile, trainer_type, distances, x, y);
+        tile->distances.store(trainer_type, x, y, distances);
+    }
+
+    return 0;
+
+}
+
+/*
+ * Updates the trainer distance Tile of trainer_type after the PC moved from from_x, from_y to where it is now, from the
+ * tile's cached field for the new cell if there is one.
+ */
+int update_distances(Tile *tile, enum character_type trainer_type, int from_x, int from_y) {
+
+    int (*distances)[TILE_WIDTH_X] = trainer_type == RIVAL ? rival_distance_tile : hiker_distance_tile;
+    int x = tile->player_character->x;
+    int y = tile->player_character->y;
+    if (!tile->distances.load(trainer_type, x, y, distances)) {
+        update_distance_field(tile, trainer_type, distances, from_x, from_y, x, y);
+        tile->distances.store(trainer_type, x, y, distances);
+    }
+
+    return 0;
+
+}
+
+/*
+ * Fills distances with the cost for a trainer of trainer_type to get from each cell to x, y, INT_MAX where it cannot.
+ *
+ * @return cells settled
+ */
+int distance_field(Tile *tile, enum character_type trainer_type, int distances[TILE_LENGTH_Y][TILE_WIDTH_X], int x,
+                   int y) {
+
+    for (int i = 0; i < TILE_LENGTH_Y; i++) {
+        for (int j = 0; j < TILE_WIDTH_X; j++) {
+            distances[i][j] = INT_MAX;
         }
     }
-    //updates appropriate trainer distance Tile for the data to endure through future dijkstra calls
+    distances[y][x] = 0;
+
+    return relax_distances(tile, trainer_type, distances, x, y);
+
+}
+
+/*
+ * Changes distances, filled by distance_field for from_x, from_y, into those for x, y. Going back to from_x, from_y
+ * first is still a way to every cell, so old distances plus that step are upper bounds and only cells x, y is closer to
+ * are relaxed again, out from x, y. Recomputes the whole field when x, y is not next to from_x, from_y or trainers
+ * cannot step onto from_x, from_y.
+ *
+ * @return cells settled
+ */
+int update_distance_field(Tile *tile, enum character_type trainer_type, int distances[TILE_LENGTH_Y][TILE_WIDTH_X],
+                          int from_x, int from_y, int x, int y) {
+
+    if (x == from_x && y == from_y) {
+        return 0;
+    }
+    int back = trainer_type == RIVAL ? tile->terrain_at(from_x, from_y).rival_weight
+                                     : tile->terrain_at(from_x, from_y).hiker_weight;
+    if (abs(x - from_x) > 1 || abs(y - from_y) > 1 || back == INT_MAX) {
+        return distance_field(tile, trainer_type, distances, x, y);
+    }
     for (int i = 0; i < TILE_LENGTH_Y; i++) {
         for (int j = 0; j < TILE_WIDTH_X; j++) {
-            if (trainer_type == RIVAL) {
-                rival_distance_tile[i][j] = tile->tile[i][j].distance;
-            }
-            else {
-                //printable_character type_enum = hiker
-                hiker_distance_tile[i][j] = tile->tile[i][j].distance;
+            if (distances[i][j] != INT_MAX) {
+                distances[i][j] += back;
             }
         }
     }
+    distances[y][x] = 0;
 
-    //todo: BUG: uncomment code below and debug. Currently replaced by all points distance set to int max = no trainer movement.
-//    int start_x = tile->player_character->x;
-//    int start_y =tile->player_character->y;
-//
-//    for (int y = 0; y < TILE_LENGTH_Y; y++) {
-//        for (int x = 0; x < TILE_WIDTH_X; x++) {
-//            tile->tile[y][x].distance = INT_MAX;
-//        }
-//    }
-//    tile->tile[start_y][start_x].distance = 0;
-//
-//    struct heap heap;
-//    static Point *point;
-//    heap_init(&heap, comparator_trainer_distance_tile, NULL);
-//    for (int y = 0; y < TILE_LENGTH_Y; y++) {
-//        for (int x = 0; x < TILE_WIDTH_X; x++) {
-//            int weight;
-//            if (trainer_type == RIVAL) {
-//                weight = tile->tile[y][x].terrain.rival_weight;
-//            }
-//            else {
-//                //character_type type_enum == hiker
-//                weight = tile->tile[y][x].terrain.hiker_weight;
-//            }
-//            if (weight != INT_MAX) {
-//                tile->tile[y][x].heap_node = heap_insert(&heap, &(tile->tile[y][x]));
-//            }
-//            else {
-//                tile->tile[y][x].heap_node = NULL;
-//            }
-//        }
-//    }
-//    //todo: BUG: crashes on heap remove min in heap restructuring after some number of iterations. Usually when crashing heap size is around 800 to 1100
-//    while ((point = (Point *) heap_remove_min(&heap))) {
-//        point->heap_node = NULL;
-//        for (int y = -1; y <= 1; y++) {
-//            for (int x = -1; x <= 1; x++) {
-//                if (point->y + y >= 0 && point->y + y < TILE_LENGTH_Y && point->x + x >= 0 && point->x + x < TILE_WIDTH_X)
-//                {
-//                    Point *neighbor = &(tile->tile[point->y + y][point->x + x]);
-//                    int candidate_distance;
-//                    if (trainer_type == RIVAL) {
-//                        candidate_distance = point->distance + neighbor->terrain.rival_weight;
-//                    } else {
-//                        //character_type type_enum == hiker
-//                        candidate_distance = point->distance + neighbor->terrain.hiker_weight;
-//                    }
-//                    if (neighbor->heap_node != NULL && candidate_distance < neighbor->distance &&
-//                        candidate_distance > 0) {
-//                        neighbor->distance = candidate_distance;
-//                        heap_decrease_key_no_replace(&heap, neighbor->heap_node);
-//                    }
-//                }
-//            }
-//        }
-//    }
-//    heap_delete(&heap);
-//
-//    //updates appropriate trainer distance Tile for the data to endure through future dijkstra calls
-//    for (int i = 0; i < TILE_LENGTH_Y; i++) {
-//        for (int j = 0; j < TILE_WIDTH_X; j++) {
-//            if (trainer_type == RIVAL) {
-//                rival_distance_tile[i][j] = tile->tile[i][j].distance;
-//            }
-//            else {
-//                //printable_character type_enum = hiker
-//                hiker_distance_tile[i][j] = tile->tile[i][j].distance;
-//            }
-//        }
-//    }
+    return relax_distances(tile, trainer_type, distances, x, y);
 
-    return 0;
+}
+
+/*
+ * Lowers distances out from x, y with Dial's algorithm: a cell costs its rival_weight or hiker_weight to step onto,
+ * all under DISTANCE_BUCKETS, so cells waiting to be settled are never further apart than that and a ring of buckets
+ * by distance replaces the heap. Only cells a shorter way was found to are visited.
+ *
+ * @return cells settled
+ */
+int relax_distances(Tile *tile, enum character_type trainer_type, int distances[TILE_LENGTH_Y][TILE_WIDTH_X], int x,
+                    int y) {
+
+    //kept between calls so they are allocated once
+    static std::vector<uint16_t> buckets[DISTANCE_BUCKETS];
+    int settled = 0;
+    int pending = 1;
+    int current = distances[y][x];
+    buckets[current % DISTANCE_BUCKETS].push_back((uint16_t) (y * TILE_WIDTH_X + x));
+    while (pending > 0) {
+        std::vector<uint16_t> &bucket = buckets[current % DISTANCE_BUCKETS];
+        while (!bucket.empty()) {
+            int cell_x = bucket.back() % TILE_WIDTH_X;
+            int cell_y = bucket.back() / TILE_WIDTH_X;
+            bucket.pop_back();
+            pending--;
+            //left behind when the cell was lowered again
+            if (distances[cell_y][cell_x] != current) {
+                continue;
+            }
+            settled++;
+            for (int d = 0; d < 8; d++) {
+                int neighbor_x = cell_x + direction_x[d];
+                int neighbor_y = cell_y + direction_y[d];
+                if (neighbor_x < 0 || neighbor_x >= TILE_WIDTH_X || neighbor_y < 0 || neighbor_y >= TILE_LENGTH_Y) {
+                    continue;
+                }
+                int weight = trainer_type == RIVAL ? tile->terrain_at(neighbor_x, neighbor_y).rival_weight
+                                                   : tile->terrain_at(neighbor_x, neighbor_y).hiker_weight;
+                if (weight != INT_MAX && current + weight < distances[neighbor_y][neighbor_x]) {
+                    distances[neighbor_y][neighbor_x] = current + weight;
+                    buckets[(current + weight) % DISTANCE_BUCKETS].push_back(
+                            (uint16_t) (neighbor_y * TILE_WIDTH_X + neighbor_x));
+                    pending++;
+                }
+            }
+        }
+        current++;
+    }
+
+    return settled;
 
 }
 
-int legal_overwrite(Point point) {
+int legal_overwrite(int terrain) {
 
-    if (point.terrain.id == edge->id
-        || point.terrain.id == path->id
-        || point.terrain.id == center->id
-        || point.terrain.id == mart->id) {
+    if (terrain == edge->id
+        || terrain == path->id
+        || terrain == center->id
+        || terrain == mart->id) {
         return 1;
     }
     else {
@@ -4519,19 +7977,19 @@ int print_tile_terrain(Tile *tile) {
     interface->clearUI();
     for (int y = 0; y < TILE_LENGTH_Y; y++) {
         for (int x = 0; x < TILE_WIDTH_X; x++) {
-            char printable_character = tile->tile[y][x].terrain.printable_character;
-            if (tile->tile[y][x].character != NULL) {
-                printable_character = tile->tile[y][x].character->printable_character;
-                interface->attronUI(tile->tile[y][x].character->color);
+            char printable_character = tile->terrain_at(x, y).printable_character;
+            if (tile->character_at(x, y) != NULL) {
+                printable_character = tile->character_at(x, y)->printable_character;
+                interface->attronUI(tile->character_at(x, y)->color);
                 interface->mvaddchUI(y + 1, x, printable_character);
                 interface->refreshUI();
-                interface->attroffUI(tile->tile[y][x].character->color);
+                interface->attroffUI(tile->character_at(x, y)->color);
             }
             else {
-                interface->attronUI(tile->tile[y][x].terrain.color);
+                interface->attronUI(tile->terrain_at(x, y).color);
                 interface->mvaddchUI(y + 1, x, printable_character);
                 interface->refreshUI();
-                interface->attroffUI(tile->tile[y][x].terrain.color);
+                interface->attroffUI(tile->terrain_at(x, y).color);
             }
         }
     }
@@ -4546,20 +8004,20 @@ int print_tile_trainer_distances(Tile *tile) {
 
     dijkstra(tile, RIVAL);
     printf("Rival distance Tile:\n");
-    print_tile_trainer_distances_printer(tile);
+    print_tile_trainer_distances_printer(rival_distance_tile);
     dijkstra(tile, HIKER);
     printf("Hiker distance Tile:\n");
-    print_tile_trainer_distances_printer(tile);
+    print_tile_trainer_distances_printer(hiker_distance_tile);
 
     return 0;
 
 }
 
-int print_tile_trainer_distances_printer(Tile *tile) {
+int print_tile_trainer_distances_printer(int distances[TILE_LENGTH_Y][TILE_WIDTH_X]) {
 
     for (int i = 0; i < TILE_LENGTH_Y; i++) {
         for (int j = 0; j < TILE_WIDTH_X; j++) {
-            int distance = tile->tile[i][j].distance;
+            int distance = distances[i][j];
             if (distance == INT_MAX) {
                 printf("  ");
             }
@@ -4569,7 +8027,7 @@ int print_tile_trainer_distances_printer(Tile *tile) {
                 printf("\033[0m");
             }
             else {
-                printf("%02d", tile->tile[i][j].distance % 100);
+                printf("%02d", distance % 100);
             }
             printf(" ");
         }
@@ -0,0 +1,442 @@
+#ifndef POKEMON_PRIORITY_QUEUE_H
+#define POKEMON_PRIORITY_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+//Author Maxim Popov
+
+/*
+ * Typed priority queues to use instead of heap_t where the comparison is hot: the element type and comparator are
+ * template parameters, so comparisons inline instead of going through void pointers and a function pointer. In all of
+ * them compare(a, b) is true when a comes out before b, so std::less gives the smallest first like heap_t.
+ */
+
+/*
+ * Implicit heap in a vector where every node has Arity children. Arity 4 keeps the children of a node in one cache line
+ * for small elements and halves the depth of a binary heap.
+ */
+template <typename T, typename Compare = std::less<T>, int Arity = 4>
+class DaryHeap {
+public:
+    std::vector<T> items;
+    Compare compare;
+
+    explicit DaryHeap(Compare compare = Compare()) : compare(compare) {}
+
+    bool empty() const {
+        return items.empty();
+    }
+
+    size_t size() const {
+        return items.size();
+    }
+
+    const T &top() const {
+        return items.front();
+    }
+
+    void reserve(size_t capacity) {
+        items.reserve(capacity);
+    }
+
+    void clear() {
+        items.clear();
+    }
+
+    void push(T item) {
+
+        size_t index = items.size();
+        items.push_back(std::move(item));
+        sift_up(index);
+
+    }
+
+    T pop() {
+
+        T item = std::move(items.front());
+        if (items.size() > 1) {
+            items.front() = std::move(items.back());
+            items.pop_back();
+            sift_down(0);
+        }
+        else {
+            items.pop_back();
+        }
+        return item;
+
+    }
+
+private:
+    void sift_up(size_t index) {
+
+        T item = std::move(items[index]);
+        while (index > 0) {
+            size_t parent = (index - 1) / Arity;
+            if (!compare(item, items[parent])) {
+                break;
+            }
+            items[index] = std::move(items[parent]);
+            index = parent;
+        }
+        items[index] = std::move(item);
+
+    }
+
+    void sift_down(size_t index) {
+
+        T item = std::move(items[index]);
+        size_t size = items.size();
+        for (;;) {
+            size_t first = index * Arity + 1;
+            if (first >= size) {
+                break;
+            }
+            size_t last = first + Arity < size ? first + Arity : size;
+            size_t best = first;
+            for (size_t child = first + 1; child < last; child++) {
+                if (compare(items[child], items[best])) {
+                    best = child;
+                }
+            }
+            if (!compare(items[best], item)) {
+                break;
+            }
+            items[index] = std::move(items[best]);
+            index = best;
+        }
+        items[index] = std::move(item);
+
+    }
+};
+
+template <typename T, typename Compare = std::less<T>>
+using BinaryHeap = DaryHeap<T, Compare, 2>;
+
+/*
+ * Pairing heap. push is O(1) and hands back the node of the element, which decrease takes to move it up after its value
+ * was lowered. Nodes come from slabs the heap owns, and popped ones are reused, so it only allocates while growing.
+ */
+template <typename T, typename Compare = std::less<T>>
+class PairingHeap {
+public:
+    struct Node {
+        T value;
+        Node *child;
+        Node *next;
+        //the parent for a first child, the previous sibling otherwise
+        Node *previous;
+    };
+
+    explicit PairingHeap(Compare compare = Compare()) : compare(compare), root(NULL), free_nodes(NULL), count(0),
+                                                        slabs_started(0), slab_used(0) {}
+
+    PairingHeap(const PairingHeap &) = delete;
+    PairingHeap &operator=(const PairingHeap &) = delete;
+
+    bool empty() const {
+        return root == NULL;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    const T &top() const {
+        return root->value;
+    }
+
+    Node *push(T value) {
+
+        Node *node = allocate();
+        node->value = std::move(value);
+        node->child = NULL;
+        node->next = NULL;
+        node->previous = NULL;
+        root = root == NULL ? node : meld(root, node);
+        count++;
+        return node;
+
+    }
+
+    T pop() {
+
+        Node *old_root = root;
+        T value = std::move(old_root->value);
+        root = merge_pairs(old_root->child);
+        if (root != NULL) {
+            root->previous = NULL;
+        }
+        old_root->next = free_nodes;
+        free_nodes = old_root;
+        count--;
+        return value;
+
+    }
+
+    //node's value must not come out later than before
+    void decrease(Node *node, T value) {
+
+        node->value = std::move(value);
+        if (node == root) {
+            return;
+        }
+        //cut node out from its parent or previous sibling and meld it back in at the root
+        if (node->previous->child == node) {
+            node->previous->child = node->next;
+        }
+        else {
+            node->previous->next = node->next;
+        }
+        if (node->next != NULL) {
+            node->next->previous = node->previous;
+        }
+        node->next = NULL;
+        node->previous = NULL;
+        root = meld(root, node);
+
+    }
+
+    //drops all elements but keeps the slabs for the next pushes
+    void clear() {
+
+        root = NULL;
+        free_nodes = NULL;
+        count = 0;
+        slabs_started = 0;
+        slab_used = 0;
+
+    }
+
+private:
+    Compare compare;
+    Node *root;
+    Node *free_nodes;
+    size_t count;
+    //slab i holds slab_capacity(i) nodes
+    std::vector<std::unique_ptr<Node[]>> slabs;
+    //slabs handed out nodes from since the last clear, the last of which is being filled
+    size_t slabs_started;
+    size_t slab_used;
+
+    static size_t slab_capacity(size_t slab) {
+        return (size_t) 64 << (slab < 10 ? slab : 10);
+    }
+
+    Node *allocate() {
+
+        if (free_nodes != NULL) {
+            Node *node = free_nodes;
+            free_nodes = node->next;
+            return node;
+        }
+        if (slabs_started == 0 || slab_used == slab_capacity(slabs_started - 1)) {
+            if (slabs_started == slabs.size()) {
+                slabs.emplace_back(new Node[slab_capacity(slabs_started)]);
+            }
+            slabs_started++;
+            slab_used = 0;
+        }
+        return &slabs[slabs_started - 1][slab_used++];
+
+    }
+
+    //links two roots, the one coming out later becoming the first child of the other
+    Node *meld(Node *a, Node *b) {
+
+        if (compare(b->value, a->value)) {
+            std::swap(a, b);
+        }
+        b->previous = a;
+        b->next = a->child;
+        if (a->child != NULL) {
+            a->child->previous = b;
+        }
+        a->child = b;
+        return a;
+
+    }
+
+    //melds siblings in pairs from the left, then the pairs into one from the right
+    Node *merge_pairs(Node *first) {
+
+        if (first == NULL) {
+            return NULL;
+        }
+        Node *pairs = NULL;
+        while (first != NULL) {
+            Node *a = first;
+            Node *b = a->next;
+            if (b == NULL) {
+                first = NULL;
+            }
+            else {
+                first = b->next;
+                b->next = NULL;
+                b->previous = NULL;
+                a = meld(a, b);
+            }
+            a->next = pairs;
+            a->previous = NULL;
+            pairs = a;
+        }
+        Node *merged = pairs;
+        pairs = pairs->next;
+        merged->next = NULL;
+        while (pairs != NULL) {
+            Node *next = pairs->next;
+            pairs->next = NULL;
+            merged = meld(merged, pairs);
+            pairs = next;
+        }
+        return merged;
+
+    }
+};
+
+/*
+ * Heap of the ids 0 to capacity - 1, each with a key of type Key, that knows where every id is so its key can be
+ * lowered in place, as Dijkstra needs. Positions and keys are arrays by id, so nothing is allocated after construction.
+ */
+template <typename Key, typename Compare = std::less<Key>, int Arity = 4>
+class IndexedHeap {
+public:
+    explicit IndexedHeap(size_t capacity, Compare compare = Compare()) : compare(compare), keys(capacity),
+                                                                         positions(capacity, ABSENT) {
+        heap.reserve(capacity);
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    size_t size() const {
+        return heap.size();
+    }
+
+    bool contains(uint32_t id) const {
+        return positions[id] != ABSENT;
+    }
+
+    const Key &key(uint32_t id) const {
+        return keys[id];
+    }
+
+    uint32_t top() const {
+        return heap.front();
+    }
+
+    void push(uint32_t id, Key key) {
+
+        keys[id] = std::move(key);
+        positions[id] = (uint32_t) heap.size();
+        heap.push_back(id);
+        sift_up(positions[id]);
+
+    }
+
+    //key must not come out later than the one id has
+    void decrease(uint32_t id, Key key) {
+
+        keys[id] = std::move(key);
+        sift_up(positions[id]);
+
+    }
+
+    //pushes id, or lowers its key if it is in the heap with a key coming out later
+    bool push_or_decrease(uint32_t id, const Key &key) {
+
+        if (!contains(id)) {
+            push(id, key);
+            return true;
+        }
+        if (compare(key, keys[id])) {
+            decrease(id, key);
+            return true;
+        }
+        return false;
+
+    }
+
+    uint32_t pop() {
+
+        uint32_t id = heap.front();
+        positions[id] = ABSENT;
+        uint32_t last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            positions[last] = 0;
+            sift_down(0);
+        }
+        return id;
+
+    }
+
+    void clear() {
+
+        for (uint32_t id : heap) {
+            positions[id] = ABSENT;
+        }
+        heap.clear();
+
+    }
+
+private:
+    static constexpr uint32_t ABSENT = UINT32_MAX;
+    Compare compare;
+    std::vector<Key> keys;
+    std::vector<uint32_t> positions;
+    std::vector<uint32_t> heap;
+
+    void sift_up(uint32_t index) {
+
+        uint32_t id = heap[index];
+        while (index > 0) {
+            uint32_t parent = (index - 1) / Arity;
+            if (!compare(keys[id], keys[heap[parent]])) {
+                break;
+            }
+            heap[index] = heap[parent];
+            positions[heap[index]] = index;
+            index = parent;
+        }
+        heap[index] = id;
+        positions[id] = index;
+
+    }
+
+    void sift_down(uint32_t index) {
+
+        uint32_t id = heap[index];
+        uint32_t size = (uint32_t) heap.size();
+        for (;;) {
+            uint32_t first = index * Arity + 1;
+            if (first >= size) {
+                break;
+            }
+            uint32_t last = first + Arity < size ? first + Arity : size;
+            uint32_t best = first;
+            for (uint32_t child = first + 1; child < last; child++) {
+                if (compare(keys[heap[child]], keys[heap[best]])) {
+                    best = child;
+                }
+            }
+            if (!compare(keys[heap[best]], keys[id])) {
+                break;
+            }
+            heap[index] = heap[best];
+            positions[heap[index]] = index;
+            index = best;
+        }
+        heap[index] = id;
+        positions[id] = index;
+
+    }
+};
+
+#endif //POKEMON_PRIORITY_QUEUE_H